@@ -1,7 +1,7 @@
 /*
 Description: This is an example of how to use the HttpClient.
-This show how to send a GET request to a URL and save the response to a file.
-and how to parse the response file based on the file type.
+This show how to send a GET request to a URL
+and how to parse the response in memory, detecting its format from the content.
 
 Note:
 This code requires the curl library to run.
@@ -10,7 +10,6 @@ g++ -std=c++17 file.cpp -lcurl -o file && ./file
 */
 #include "libs/HttpClient.hpp"
 #include "libs/FileParser.hpp"
-#include "libs/FileManager.hpp"
 #include "libs/Logger.hpp"
 
 void sendUrlRequest(const std::string& url);
@@ -43,34 +42,18 @@ int main(int argc, char* argv[]) {
  */
 void sendUrlRequest(const std::string& url) {
     HttpClient httpClient; // HTTP client object
-    FileManager fileManager; // File manager object
     FileParser fileParser; // File parser object
 
     try {
         // Example GET request
         std::string response = httpClient.getRequest(url);
         logger.log("GET Response: \n" + response);
-        std::string outputResponseFile = "response.txt";
-
-        // Save the file Response to a file
-        fileManager.createFile(outputResponseFile);
-        fileManager.updateFile(outputResponseFile, response);
 
         // Store the parsed data.
         std::map<std::string,std::string> parsedData;
 
-        // Determine the file type based on the URL and Parse the file based on the determined file type
-        std::string fileType;
-        if (url.find(".json") != std::string::npos) {
-            parsedData = fileParser.parseJSON(outputResponseFile);
-        } else if (url.find(".xml") != std::string::npos) {
-            parsedData = fileParser.parseXML(outputResponseFile);
-        } else if (url.find(".csv") != std::string::npos) {
-            parsedData = fileParser.parseCSV(outputResponseFile);
-        } else {
-            parsedData = fileParser.parseJSON(outputResponseFile);
-            return;
-        }
+        // Detect the format from the response body and parse it directly from memory
+        parsedData = fileParser.parseBuffer(response);
         
         // Now dynamically accessing the parsed data
         logger.log("Parsed Data:");
@@ -78,9 +61,6 @@ void sendUrlRequest(const std::string& url) {
             std::cout << (key + ": " + value) << std::endl;
         }
         logger.log("Parsed Data End");
-
-        // Delete the file
-        fileManager.deleteFile(outputResponseFile);
     } catch (const std::exception& e) {
         logger.error("An error occurred: " + std::string(e.what()));
     }
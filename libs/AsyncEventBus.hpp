@@ -0,0 +1,387 @@
+#ifndef ASYNCEVENTBUS_HPP
+#define ASYNCEVENTBUS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Logger.hpp"
+#include "Delegate.hpp"
+#include "ConcurrentEventBus.hpp"
+
+/**
+ * @brief The priority of an event posted to an AsyncEventBus; higher priorities are delivered first.
+ */
+enum class EventPriority
+{
+    High,
+    Normal,
+    Low
+};
+
+/**
+ * @brief What AsyncEventBus::post does when the queue it posts to is full.
+ */
+enum class OverflowPolicy
+{
+    Block,      // Wait until a worker makes room
+    DropNewest, // Reject the event being posted
+    DropOldest  // Discard the oldest queued event of the lowest priority, unless the new one is lower still
+};
+
+/**
+ * @brief Options for AsyncEventBus.
+ */
+struct AsyncBusOptions
+{
+    size_t workerCount = 0;                     // Worker threads; 0 uses the number of hardware threads
+    size_t capacity = 4096;                     // Events that may be queued, spread evenly over the workers
+    OverflowPolicy overflow = OverflowPolicy::Block;
+    bool ordered = true;                        // Deliver events of one type in posting order; false lets idle workers steal
+    std::chrono::milliseconds stealInterval{1}; // Unordered only: how often an idle worker looks at the other queues
+};
+
+/**
+ * @brief The AsyncEventBus class delivers events to their handlers on a pool of worker threads, so
+ * posting an event never waits for a slow handler.
+ *
+ * Each worker owns a bounded queue with one FIFO per priority. With ordered delivery (the default)
+ * all events of one type go to the same worker, so they are handled one at a time in the order
+ * they were posted (within a priority). Otherwise events are spread round-robin and a worker whose
+ * queue is empty takes events from the others. When a queue is full, the OverflowPolicy decides
+ * whether post() waits, rejects the event or drops an older one. A handler posting to a full queue
+ * of its own bus never waits, as that could deadlock the pool; the event is queued over capacity.
+ *
+ * Handlers are kept in a ConcurrentEventBus, so subscribing and unsubscribing is safe at any time,
+ * and publish() still delivers synchronously on the calling thread. Exceptions from handlers
+ * running on the workers are logged and counted.
+ */
+class AsyncEventBus
+{
+public:
+    using SubscriptionId = ConcurrentEventBus::SubscriptionId;
+
+    /**
+     * @brief Starts the worker threads.
+     * @param options The pool size, queue capacity, overflow policy and ordering.
+     */
+    explicit AsyncEventBus(const AsyncBusOptions &options = AsyncBusOptions())
+        : logger([]()
+                 {
+            std::string currentFile = __FILE__;
+            std::string::size_type pos = currentFile.find_last_of("/\\");
+            std::string fileName = currentFile.substr(pos + 1, currentFile.rfind(".") - pos - 1);
+            std::string logFilename = Logger::getLogsFilename(fileName);
+            return logFilename; }()),
+          options(options)
+    {
+        size_t workerCount = options.workerCount != 0 ? options.workerCount : std::max(1u, std::thread::hardware_concurrency());
+        shardCapacity = std::max<size_t>(1, options.capacity / workerCount);
+        for (size_t i = 0; i < workerCount; ++i)
+        {
+            shards.push_back(std::make_unique<Shard>());
+        }
+        workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; ++i)
+        {
+            workers.emplace_back([this, i]()
+                                 { run(i); });
+        }
+        log("AsyncEventBus instance created with " + std::to_string(workerCount) + " workers");
+    }
+
+    AsyncEventBus(const AsyncEventBus &) = delete;
+    AsyncEventBus &operator=(const AsyncEventBus &) = delete;
+
+    /**
+     * @brief Delivers every event already queued, then joins the workers. Posts from then on fail.
+     */
+    ~AsyncEventBus()
+    {
+        for (std::unique_ptr<Shard> &shard : shards)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->stopping = true;
+            shard->ready.notify_all();
+            shard->space.notify_all();
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Subscribes a handler to events of type Event (see ConcurrentEventBus::subscribe).
+     */
+    template <typename Event, typename Handler>
+    SubscriptionId subscribe(Handler &&handler)
+    {
+        return bus.subscribe<Event>(std::forward<Handler>(handler));
+    }
+
+    /**
+     * @brief Removes a subscription (see ConcurrentEventBus::unsubscribe).
+     */
+    bool unsubscribe(SubscriptionId subscription)
+    {
+        return bus.unsubscribe(subscription);
+    }
+
+    /**
+     * @brief Delivers an event synchronously on the calling thread.
+     */
+    template <typename Event>
+    void publish(const Event &event)
+    {
+        bus.publish(event);
+    }
+
+    /**
+     * @brief Queues an event for delivery on a worker thread.
+     * @param event The event; it is copied or moved into the queue.
+     * @param priority Events of higher priority queued on the same worker are delivered first.
+     * @return false if the event was rejected because the queue was full or the bus is stopping.
+     */
+    template <typename Event>
+    bool post(Event &&event, EventPriority priority = EventPriority::Normal)
+    {
+        using Stored = std::decay_t<Event>;
+        size_t type = EventBus::typeId<Stored>();
+        size_t index = options.ordered ? type % shards.size() : nextShard.fetch_add(1, std::memory_order_relaxed) % shards.size();
+        Task task([this, event = std::forward<Event>(event)]()
+                  { bus.publish(event); });
+        return enqueue(*shards[index], std::move(task), priority);
+    }
+
+    /**
+     * @brief Waits until every event posted so far has been delivered.
+     * Must not be called from a handler running on a worker.
+     */
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idle.wait(lock, [this]()
+                  { return pendingCount.load() == 0; });
+    }
+
+    /**
+     * @brief Returns the number of events queued or being delivered.
+     */
+    size_t pending() const { return pendingCount.load(); }
+
+    /**
+     * @brief Returns the number of events rejected or discarded because a queue was full.
+     */
+    uint64_t dropped() const { return droppedCount.load(); }
+
+    /**
+     * @brief Returns the number of deliveries on the workers in which a handler threw.
+     */
+    uint64_t failed() const { return failedCount.load(); }
+
+private:
+    using Task = Delegate<void()>;
+
+    static constexpr size_t priorityCount = 3;
+
+    // The queue of one worker
+    struct Shard
+    {
+        std::mutex mutex;
+        std::condition_variable ready; // Signalled when an event is queued or the bus stops
+        std::condition_variable space; // Signalled when an event is taken or the bus stops
+        std::deque<Task> queues[priorityCount]; // By EventPriority
+        size_t size = 0;
+        bool stopping = false;
+    };
+
+    Logger logger; // Logger instance for logging events
+    std::mutex logMutex; // Serializes logging between threads
+    AsyncBusOptions options;
+    ConcurrentEventBus bus; // Holds the handlers
+    size_t shardCapacity = 1;
+    std::vector<std::unique_ptr<Shard>> shards; // One per worker
+    std::vector<std::thread> workers;
+    std::atomic<size_t> nextShard{0}; // Round-robin position for unordered posting
+
+    std::atomic<size_t> pendingCount{0};
+    std::atomic<uint64_t> droppedCount{0};
+    std::atomic<uint64_t> failedCount{0};
+    std::mutex idleMutex; // Guards the wakeup of flush()
+    std::condition_variable idle;
+
+    void log(const std::string &message)
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        logger.log(message);
+    }
+
+    static const AsyncEventBus *&currentWorkerBus()
+    {
+        thread_local const AsyncEventBus *bus = nullptr;
+        return bus;
+    }
+
+    bool enqueue(Shard &shard, Task task, EventPriority priority)
+    {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        if (shard.size >= shardCapacity && !shard.stopping)
+        {
+            if (options.overflow == OverflowPolicy::DropNewest)
+            {
+                ++droppedCount;
+                return false;
+            }
+            if (options.overflow == OverflowPolicy::DropOldest)
+            {
+                size_t lowest = priorityCount;
+                while (lowest > 0 && shard.queues[lowest - 1].empty())
+                {
+                    --lowest;
+                }
+                if (static_cast<size_t>(priority) > lowest - 1)
+                {
+                    ++droppedCount;
+                    return false; // Everything queued matters more
+                }
+                shard.queues[lowest - 1].pop_front();
+                --shard.size;
+                ++droppedCount;
+                finished();
+            }
+            else if (currentWorkerBus() != this)
+            {
+                shard.space.wait(lock, [&]()
+                                 { return shard.size < shardCapacity || shard.stopping; });
+            }
+        }
+        if (shard.stopping)
+        {
+            return false;
+        }
+        shard.queues[static_cast<size_t>(priority)].push_back(std::move(task));
+        ++shard.size;
+        ++pendingCount;
+        lock.unlock();
+        shard.ready.notify_one();
+        return true;
+    }
+
+    // Takes the highest-priority event of a shard whose lock is held
+    static Task takeLocked(Shard &shard)
+    {
+        for (std::deque<Task> &queue : shard.queues)
+        {
+            if (!queue.empty())
+            {
+                Task task = std::move(queue.front());
+                queue.pop_front();
+                --shard.size;
+                return task;
+            }
+        }
+        return Task();
+    }
+
+    // Takes an event from another worker's queue without waiting for its lock
+    Task steal(size_t self)
+    {
+        for (size_t offset = 1; offset < shards.size(); ++offset)
+        {
+            Shard &victim = *shards[(self + offset) % shards.size()];
+            std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+            if (lock.owns_lock() && victim.size > 0)
+            {
+                Task task = takeLocked(victim);
+                lock.unlock();
+                victim.space.notify_one();
+                return task;
+            }
+        }
+        return Task();
+    }
+
+    void run(size_t self)
+    {
+        currentWorkerBus() = this;
+        Shard &shard = *shards[self];
+        while (true)
+        {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(shard.mutex);
+                auto hasWork = [&]()
+                { return shard.size > 0 || shard.stopping; };
+                if (options.ordered)
+                {
+                    shard.ready.wait(lock, hasWork);
+                }
+                else
+                {
+                    shard.ready.wait_for(lock, options.stealInterval, hasWork);
+                }
+                if (shard.size > 0)
+                {
+                    task = takeLocked(shard);
+                }
+                else if (shard.stopping)
+                {
+                    return;
+                }
+            }
+            if (task)
+            {
+                shard.space.notify_one();
+            }
+            else if (!options.ordered)
+            {
+                task = steal(self);
+            }
+            if (task)
+            {
+                deliver(task);
+            }
+        }
+    }
+
+    void deliver(const Task &task)
+    {
+        try
+        {
+            task();
+        }
+        catch (const std::exception &e)
+        {
+            ++failedCount;
+            log(std::string("Event handler failed: ") + e.what());
+        }
+        catch (...)
+        {
+            ++failedCount;
+            log("Event handler failed");
+        }
+        finished();
+    }
+
+    // Accounts for an event that was delivered or discarded and wakes flush() when none are left
+    void finished()
+    {
+        if (pendingCount.fetch_sub(1) == 1)
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            idle.notify_all();
+        }
+    }
+};
+
+#endif // ASYNCEVENTBUS_HPP
@@ -0,0 +1,634 @@
+#ifndef COLUMNARFILE_HPP
+#define COLUMNARFILE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "CsvParser.hpp"
+#include "MappedFile.hpp"
+#include "OutputBuffer.hpp"
+
+/**
+ * @brief What a columnar table was built from, so a reader can tell whether a stored copy is
+ * stale. Fields the writer did not know are 0.
+ */
+struct ColumnarSource
+{
+    uint64_t size = 0;    // Size of the source file in bytes
+    int64_t modified = 0; // Modification time of the source file in file clock ticks; 0 if not trustworthy
+    uint64_t options = 0; // The parse options, packed by the writer
+};
+
+/**
+ * @brief The ColumnarFile class stores a CsvTable in a compact binary file and reads it back
+ * through a memory mapping.
+ *
+ * Layout (host byte order, every section aligned to 8 bytes):
+ * - a FileHeader, which also records the ColumnarSource the table was built from, followed by one
+ *   ColumnHeader per column and the column names;
+ * - per column, its data: Int64 and Double values as plain arrays, or, for String columns, one
+ *   uint32_t dictionary code per row followed by the dictionary (uint64_t offsets plus characters).
+ *
+ * Each column header records min/max (for String columns: the codes of the smallest and largest
+ * dictionary entry) and the number of NaNs, so range checks need no scan. With compression,
+ * Int64 columns are stored as zigzag varints of the deltas between rows and dictionary codes as
+ * varints; these are decoded once when the file is opened. Uncompressed columns are used in place,
+ * so opening is a mapping plus a header check.
+ */
+class ColumnarFile
+{
+public:
+    /**
+     * @brief A read-only view of one column of an open file.
+     */
+    class Column
+    {
+    public:
+        std::string_view name() const { return columnName; }
+        CsvTable::ColumnType type() const { return columnType; }
+
+        /**
+         * @brief Returns the Int64 values (rowCount of them).
+         * @throws std::runtime_error if the column has another type.
+         */
+        const int64_t *int64Data() const
+        {
+            expect(CsvTable::ColumnType::Int64, "Int64");
+            return ints;
+        }
+
+        /**
+         * @brief Returns the Double values (rowCount of them); NaN marks empty fields.
+         * @throws std::runtime_error if the column has another type.
+         */
+        const double *doubleData() const
+        {
+            expect(CsvTable::ColumnType::Double, "Double");
+            return doubles;
+        }
+
+        /**
+         * @brief Returns the string at the given row of a String column.
+         * @throws std::runtime_error if the column has another type.
+         */
+        std::string_view stringAt(size_t row) const
+        {
+            expect(CsvTable::ColumnType::String, "String");
+            return dictionaryEntry(codes[row]);
+        }
+
+        /**
+         * @brief Returns the number of distinct strings of a String column.
+         */
+        size_t dictionarySize() const { return dictionaryCount; }
+
+        /**
+         * @brief Returns a distinct string of a String column by its dictionary code.
+         */
+        std::string_view dictionaryEntry(size_t code) const
+        {
+            return std::string_view(dictionaryChars + dictionaryOffsets[code], dictionaryOffsets[code + 1] - dictionaryOffsets[code]);
+        }
+
+        int64_t int64Min() const { return static_cast<int64_t>(minBits); }
+        int64_t int64Max() const { return static_cast<int64_t>(maxBits); }
+        double doubleMin() const { return bitsToDouble(minBits); }
+        double doubleMax() const { return bitsToDouble(maxBits); }
+        std::string_view stringMin() const { return dictionaryCount ? dictionaryEntry(minBits) : std::string_view(); }
+        std::string_view stringMax() const { return dictionaryCount ? dictionaryEntry(maxBits) : std::string_view(); }
+
+        /**
+         * @brief Returns the number of NaN (empty) values of a Double column.
+         */
+        uint64_t nanCount() const { return nans; }
+
+    private:
+        friend class ColumnarFile;
+
+        std::string_view columnName;
+        CsvTable::ColumnType columnType = CsvTable::ColumnType::String;
+        const int64_t *ints = nullptr;
+        const double *doubles = nullptr;
+        const uint32_t *codes = nullptr;
+        const uint64_t *dictionaryOffsets = nullptr;
+        const char *dictionaryChars = nullptr;
+        uint64_t dictionaryCount = 0;
+        uint64_t minBits = 0;
+        uint64_t maxBits = 0;
+        uint64_t nans = 0;
+        std::vector<int64_t> decodedInts;   // Storage for compressed Int64 columns
+        std::vector<uint32_t> decodedCodes; // Storage for compressed dictionary codes
+
+        void expect(CsvTable::ColumnType expected, const char *typeName) const
+        {
+            if (columnType != expected)
+            {
+                throw std::runtime_error("Columnar column '" + std::string(columnName) + "' is not " + typeName);
+            }
+        }
+    };
+
+    /**
+     * @brief Writes a table in the columnar format.
+     * @param table The table to store.
+     * @param out The destination, normally a file-mode OutputBuffer.
+     * @param compress Whether to varint-encode Int64 columns and dictionary codes.
+     * @param source What the table was built from, returned by source() when the file is opened.
+     */
+    static void write(const CsvTable &table, OutputBuffer &out, bool compress = false, const ColumnarSource &source = ColumnarSource())
+    {
+        std::vector<EncodedColumn> encoded;
+        encoded.reserve(table.columnCount());
+        for (size_t col = 0; col < table.columnCount(); ++col)
+        {
+            encoded.push_back(encodeColumn(table.column(col), table.rowCount(), compress));
+        }
+
+        // Assign offsets: headers, names, then each column's sections
+        uint64_t offset = sizeof(FileHeader) + sizeof(ColumnHeader) * encoded.size();
+        std::vector<ColumnHeader> headers(encoded.size());
+        for (size_t col = 0; col < encoded.size(); ++col)
+        {
+            headers[col] = encoded[col].header;
+            headers[col].nameOffset = offset;
+            headers[col].nameSize = table.column(col).name().size();
+            offset += headers[col].nameSize;
+        }
+        for (size_t col = 0; col < encoded.size(); ++col)
+        {
+            offset = align(offset);
+            headers[col].dataOffset = offset;
+            headers[col].dataSize = encoded[col].data.size();
+            offset += headers[col].dataSize;
+            offset = align(offset);
+            headers[col].dictionaryOffset = offset;
+            headers[col].dictionarySize = encoded[col].dictionary.size();
+            offset += headers[col].dictionarySize;
+        }
+
+        FileHeader fileHeader;
+        std::memcpy(fileHeader.magic, magic, sizeof(fileHeader.magic));
+        fileHeader.version = formatVersion;
+        fileHeader.byteOrder = byteOrderMark;
+        fileHeader.rowCount = table.rowCount();
+        fileHeader.columnCount = encoded.size();
+        fileHeader.fileSize = offset;
+        fileHeader.sourceSize = source.size;
+        fileHeader.sourceModified = source.modified;
+        fileHeader.sourceOptions = source.options;
+
+        uint64_t written = 0;
+        auto put = [&](const void *data, size_t size)
+        {
+            out.append(std::string_view(static_cast<const char *>(data), size));
+            written += size;
+        };
+        auto padTo = [&](uint64_t target)
+        {
+            static const char zeros[8] = {};
+            put(zeros, static_cast<size_t>(target - written));
+        };
+        put(&fileHeader, sizeof(fileHeader));
+        put(headers.data(), sizeof(ColumnHeader) * headers.size());
+        for (size_t col = 0; col < encoded.size(); ++col)
+        {
+            put(table.column(col).name().data(), table.column(col).name().size());
+        }
+        for (size_t col = 0; col < encoded.size(); ++col)
+        {
+            padTo(headers[col].dataOffset);
+            put(encoded[col].data.data(), encoded[col].data.size());
+            padTo(headers[col].dictionaryOffset);
+            put(encoded[col].dictionary.data(), encoded[col].dictionary.size());
+        }
+    }
+
+    /**
+     * @brief Opens a columnar file by mapping it into memory.
+     * @param path The file written by write().
+     * @throws std::runtime_error if the file cannot be read or is not a valid columnar file.
+     */
+    explicit ColumnarFile(const std::string &path) : file(std::make_unique<MappedFile>(path)), path(path)
+    {
+        const char *base = file->data();
+        if (file->size() < sizeof(FileHeader))
+        {
+            fail("file is too small");
+        }
+        FileHeader fileHeader;
+        std::memcpy(&fileHeader, base, sizeof(fileHeader));
+        if (std::memcmp(fileHeader.magic, magic, sizeof(fileHeader.magic)) != 0)
+            fail("bad magic number");
+        if (fileHeader.byteOrder != byteOrderMark)
+            fail("written on a machine with a different byte order");
+        if (fileHeader.version != formatVersion)
+            fail("unsupported version " + std::to_string(fileHeader.version));
+        if (fileHeader.fileSize != file->size())
+            fail("truncated or padded file");
+        if (fileHeader.columnCount > (file->size() - sizeof(FileHeader)) / sizeof(ColumnHeader))
+            fail("column directory exceeds the file");
+        rows = fileHeader.rowCount;
+        origin = ColumnarSource{fileHeader.sourceSize, fileHeader.sourceModified, fileHeader.sourceOptions};
+
+        const ColumnHeader *headers = reinterpret_cast<const ColumnHeader *>(base + sizeof(FileHeader));
+        columns.resize(fileHeader.columnCount);
+        for (size_t col = 0; col < columns.size(); ++col)
+        {
+            const ColumnHeader &header = headers[col];
+            Column &column = columns[col];
+            checkRange(header.nameOffset, header.nameSize, 1);
+            checkRange(header.dataOffset, header.dataSize, 8);
+            checkRange(header.dictionaryOffset, header.dictionarySize, 8);
+            column.columnName = std::string_view(base + header.nameOffset, header.nameSize);
+            column.minBits = header.minBits;
+            column.maxBits = header.maxBits;
+            column.nans = header.nanCount;
+            const char *data = base + header.dataOffset;
+            switch (header.type)
+            {
+            case static_cast<uint8_t>(CsvTable::ColumnType::Int64):
+                column.columnType = CsvTable::ColumnType::Int64;
+                if (header.encoding == Plain)
+                {
+                    expectSize(header.dataSize, rows * sizeof(int64_t));
+                    column.ints = reinterpret_cast<const int64_t *>(data);
+                }
+                else
+                {
+                    column.decodedInts = decodeDeltas(data, header.dataSize);
+                    column.ints = column.decodedInts.data();
+                }
+                break;
+            case static_cast<uint8_t>(CsvTable::ColumnType::Double):
+                column.columnType = CsvTable::ColumnType::Double;
+                expectSize(header.dataSize, rows * sizeof(double));
+                column.doubles = reinterpret_cast<const double *>(data);
+                break;
+            case static_cast<uint8_t>(CsvTable::ColumnType::String):
+                column.columnType = CsvTable::ColumnType::String;
+                openDictionary(column, header, base);
+                break;
+            default:
+                fail("unknown column type");
+            }
+        }
+    }
+
+    size_t rowCount() const { return rows; }
+    size_t columnCount() const { return columns.size(); }
+
+    /**
+     * @brief Returns what the table was built from, as passed to write().
+     */
+    const ColumnarSource &source() const { return origin; }
+
+    const Column &column(size_t index) const { return columns.at(index); }
+
+    /**
+     * @brief Returns the column with the given name.
+     * @throws std::out_of_range if there is no such column.
+     */
+    const Column &column(std::string_view name) const
+    {
+        for (const Column &candidate : columns)
+        {
+            if (candidate.name() == name)
+            {
+                return candidate;
+            }
+        }
+        throw std::out_of_range("Columnar column not found: " + std::string(name));
+    }
+
+    /**
+     * @brief Copies the file contents into a CsvTable.
+     */
+    CsvTable toTable() const
+    {
+        CsvTable table;
+        table.rows = rows;
+        table.columns.reserve(columns.size());
+        for (const Column &source : columns)
+        {
+            CsvTable::Column target(std::string(source.name()), source.type());
+            if (source.type() == CsvTable::ColumnType::Int64)
+            {
+                target.ints.assign(source.ints, source.ints + rows);
+            }
+            else if (source.type() == CsvTable::ColumnType::Double)
+            {
+                target.doubles.assign(source.doubles, source.doubles + rows);
+            }
+            else
+            {
+                target.offsets.reserve(rows + 1);
+                target.offsets.push_back(0);
+                for (size_t row = 0; row < rows; ++row)
+                {
+                    target.arena.append(source.stringAt(row));
+                    target.offsets.push_back(target.arena.size());
+                }
+            }
+            table.columns.push_back(std::move(target));
+        }
+        return table;
+    }
+
+private:
+    static constexpr char magic[4] = {'A', 'C', 'O', 'L'};
+    static constexpr uint32_t formatVersion = 2;
+    static constexpr uint32_t byteOrderMark = 0x01020304;
+
+    enum Encoding : uint8_t
+    {
+        Plain = 0,  // Fixed-width values or codes
+        Varint = 1  // Zigzag delta varints (Int64) or varint codes (String)
+    };
+
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t reserved = 0;
+        uint64_t rowCount;
+        uint64_t columnCount;
+        uint64_t fileSize;
+        uint64_t sourceSize = 0;
+        int64_t sourceModified = 0;
+        uint64_t sourceOptions = 0;
+    };
+
+    struct ColumnHeader
+    {
+        uint8_t type = 0;
+        uint8_t encoding = Plain;
+        uint8_t reserved[6] = {};
+        uint64_t nameOffset = 0;
+        uint64_t nameSize = 0;
+        uint64_t dataOffset = 0;
+        uint64_t dataSize = 0;
+        uint64_t dictionaryOffset = 0;
+        uint64_t dictionarySize = 0;
+        uint64_t dictionaryCount = 0;
+        uint64_t minBits = 0; // int64, double bits or dictionary code, depending on the type
+        uint64_t maxBits = 0;
+        uint64_t nanCount = 0;
+    };
+
+    struct EncodedColumn
+    {
+        ColumnHeader header;
+        std::string data;
+        std::string dictionary;
+    };
+
+    std::unique_ptr<MappedFile> file; // Heap-allocated so views survive moves of this object
+    std::string path;
+    size_t rows = 0;
+    ColumnarSource origin;
+    std::vector<Column> columns;
+
+    static uint64_t align(uint64_t offset) { return (offset + 7) & ~uint64_t(7); }
+
+    static uint64_t doubleToBits(double value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static double bitsToDouble(uint64_t bits)
+    {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    template <typename T>
+    static void appendRaw(std::string &out, const T *values, size_t count)
+    {
+        out.append(reinterpret_cast<const char *>(values), count * sizeof(T));
+    }
+
+    static void appendVarint(std::string &out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    static EncodedColumn encodeColumn(const CsvTable::Column &column, size_t rows, bool compress)
+    {
+        EncodedColumn encoded;
+        ColumnHeader &header = encoded.header;
+        header.type = static_cast<uint8_t>(column.type());
+        if (column.type() == CsvTable::ColumnType::Int64)
+        {
+            const std::vector<int64_t> &values = column.int64Values();
+            if (!values.empty())
+            {
+                auto range = std::minmax_element(values.begin(), values.end());
+                header.minBits = static_cast<uint64_t>(*range.first);
+                header.maxBits = static_cast<uint64_t>(*range.second);
+            }
+            if (compress)
+            {
+                header.encoding = Varint;
+                encoded.data.reserve(rows * 2);
+                uint64_t previous = 0;
+                for (int64_t value : values)
+                {
+                    uint64_t delta = static_cast<uint64_t>(value) - previous; // Wraps; undone on decode
+                    previous = static_cast<uint64_t>(value);
+                    appendVarint(encoded.data, (delta << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63));
+                }
+            }
+            else
+            {
+                appendRaw(encoded.data, values.data(), values.size());
+            }
+        }
+        else if (column.type() == CsvTable::ColumnType::Double)
+        {
+            const std::vector<double> &values = column.doubleValues();
+            double minimum = std::numeric_limits<double>::infinity();
+            double maximum = -minimum;
+            for (double value : values)
+            {
+                if (std::isnan(value))
+                {
+                    ++header.nanCount;
+                    continue;
+                }
+                minimum = std::min(minimum, value);
+                maximum = std::max(maximum, value);
+            }
+            header.minBits = doubleToBits(minimum);
+            header.maxBits = doubleToBits(maximum);
+            appendRaw(encoded.data, values.data(), values.size());
+        }
+        else
+        {
+            std::unordered_map<std::string_view, uint32_t> codeOf;
+            std::vector<std::string_view> entries;
+            std::vector<uint32_t> codes;
+            codes.reserve(rows);
+            for (size_t row = 0; row < rows; ++row)
+            {
+                std::string_view text = column.stringAt(row);
+                auto inserted = codeOf.emplace(text, static_cast<uint32_t>(entries.size()));
+                if (inserted.second)
+                {
+                    entries.push_back(text);
+                }
+                codes.push_back(inserted.first->second);
+            }
+            for (uint32_t code = 0; code < entries.size(); ++code)
+            {
+                if (entries[code] < entries[header.minBits])
+                    header.minBits = code;
+                if (entries[code] > entries[header.maxBits])
+                    header.maxBits = code;
+            }
+            header.dictionaryCount = entries.size();
+            if (compress)
+            {
+                header.encoding = Varint;
+                for (uint32_t code : codes)
+                    appendVarint(encoded.data, code);
+            }
+            else
+            {
+                appendRaw(encoded.data, codes.data(), codes.size());
+            }
+            std::vector<uint64_t> offsets;
+            offsets.reserve(entries.size() + 1);
+            uint64_t end = 0;
+            offsets.push_back(end);
+            for (std::string_view entry : entries)
+            {
+                end += entry.size();
+                offsets.push_back(end);
+            }
+            appendRaw(encoded.dictionary, offsets.data(), offsets.size());
+            for (std::string_view entry : entries)
+            {
+                encoded.dictionary.append(entry);
+            }
+        }
+        return encoded;
+    }
+
+    [[noreturn]] void fail(const std::string &message) const
+    {
+        throw std::runtime_error("Invalid columnar file " + path + ": " + message);
+    }
+
+    void checkRange(uint64_t offset, uint64_t size, uint64_t alignment) const
+    {
+        if (offset % alignment != 0 || offset > file->size() || size > file->size() - offset)
+        {
+            fail("section out of bounds");
+        }
+    }
+
+    void expectSize(uint64_t actual, uint64_t expected) const
+    {
+        if (actual != expected)
+        {
+            fail("column size does not match the row count");
+        }
+    }
+
+    template <typename Consumer>
+    void readVarints(const char *data, uint64_t size, Consumer &&consume) const
+    {
+        const unsigned char *cursor = reinterpret_cast<const unsigned char *>(data);
+        const unsigned char *end = cursor + size;
+        for (size_t row = 0; row < rows; ++row)
+        {
+            uint64_t value = 0;
+            for (int shift = 0;; shift += 7)
+            {
+                if (cursor == end || shift > 63)
+                    fail("corrupt varint data");
+                unsigned char byte = *cursor++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    break;
+            }
+            consume(value);
+        }
+        if (cursor != end)
+        {
+            fail("trailing varint data");
+        }
+    }
+
+    std::vector<int64_t> decodeDeltas(const char *data, uint64_t size) const
+    {
+        std::vector<int64_t> values;
+        values.reserve(rows);
+        uint64_t previous = 0;
+        readVarints(data, size, [&](uint64_t zigzag)
+                    {
+            uint64_t delta = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+            previous += delta;
+            values.push_back(static_cast<int64_t>(previous)); });
+        return values;
+    }
+
+    void openDictionary(Column &column, const ColumnHeader &header, const char *base)
+    {
+        uint64_t count = header.dictionaryCount;
+        if (count >= header.dictionarySize / sizeof(uint64_t))
+        {
+            fail("dictionary exceeds its section");
+        }
+        column.dictionaryCount = count;
+        column.dictionaryOffsets = reinterpret_cast<const uint64_t *>(base + header.dictionaryOffset);
+        column.dictionaryChars = base + header.dictionaryOffset + (count + 1) * sizeof(uint64_t);
+        uint64_t charsSize = header.dictionarySize - (count + 1) * sizeof(uint64_t);
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            if (column.dictionaryOffsets[i] > column.dictionaryOffsets[i + 1] || column.dictionaryOffsets[i + 1] > charsSize)
+                fail("corrupt dictionary offsets");
+        }
+        if (count > 0 && (header.minBits >= count || header.maxBits >= count))
+        {
+            fail("corrupt dictionary statistics");
+        }
+        const char *data = base + header.dataOffset;
+        if (header.encoding == Plain)
+        {
+            expectSize(header.dataSize, rows * sizeof(uint32_t));
+            column.codes = reinterpret_cast<const uint32_t *>(data);
+        }
+        else
+        {
+            column.decodedCodes.reserve(rows);
+            readVarints(data, header.dataSize, [&](uint64_t code)
+                        { column.decodedCodes.push_back(static_cast<uint32_t>(code)); });
+            column.codes = column.decodedCodes.data();
+        }
+        for (size_t row = 0; row < rows; ++row)
+        {
+            if (column.codes[row] >= count)
+                fail("dictionary code out of range");
+        }
+    }
+};
+
+#endif // COLUMNARFILE_HPP
@@ -0,0 +1,293 @@
+#ifndef CONCURRENTEVENTBUS_HPP
+#define CONCURRENTEVENTBUS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Logger.hpp"
+#include "Delegate.hpp"
+#include "EventBus.hpp"
+
+/**
+ * @brief The ConcurrentEventBus class is an EventBus that any number of threads may publish to,
+ * subscribe to and unsubscribe from at the same time.
+ *
+ * The handlers live in an immutable snapshot that publishers read without locks (read-copy-update):
+ * publish() announces itself on one of several reader counters, loads the current snapshot and
+ * calls the handlers, a fixed number of atomic operations with no waiting, so publishers never
+ * block each other or wait for subscribers. subscribe() and unsubscribe() copy the snapshot under a
+ * mutex, swap in the new one, and then wait for a grace period: every publish that might still see
+ * the old snapshot must finish before it and any removed handler are destroyed. Counters are spread
+ * over cache lines by thread, so publishers on different cores do not contend.
+ *
+ * Once unsubscribe() returns, the handler is neither running nor called again, so its captured
+ * state may be destroyed. The exception is a call from inside a handler of the same bus, which
+ * cannot wait for the publish it is part of; its cleanup is left to the next subscription change
+ * or to the destructor. Handlers subscribed while an event is being published may or may not be
+ * called for it. Publishes must not overlap the destruction of the bus.
+ */
+class ConcurrentEventBus
+{
+public:
+    using SubscriptionId = uint64_t;
+
+    /**
+     * @brief Constructs a ConcurrentEventBus object.
+     */
+    ConcurrentEventBus()
+        : logger([]()
+                 {
+            std::string currentFile = __FILE__;
+            std::string::size_type pos = currentFile.find_last_of("/\\");
+            std::string fileName = currentFile.substr(pos + 1, currentFile.rfind(".") - pos - 1);
+            std::string logFilename = Logger::getLogsFilename(fileName);
+            return logFilename; }()),
+          current(new Snapshot())
+    {
+        log("ConcurrentEventBus instance created");
+    }
+
+    ConcurrentEventBus(const ConcurrentEventBus &) = delete;
+    ConcurrentEventBus &operator=(const ConcurrentEventBus &) = delete;
+
+    ~ConcurrentEventBus()
+    {
+        delete current.load();
+    }
+
+    /**
+     * @brief Subscribes a handler to events of type Event.
+     * @param handler Called as handler(const Event &) for each published event, possibly on
+     * several threads at once.
+     * @return The id to pass to unsubscribe.
+     */
+    template <typename Event, typename Handler>
+    SubscriptionId subscribe(Handler &&handler)
+    {
+        size_t type = EventBus::typeId<Event>();
+        auto delegate = std::make_unique<Callback>([handler = std::forward<Handler>(handler)](const void *event)
+                                                   { handler(*static_cast<const std::decay_t<Event> *>(event)); });
+        SubscriptionId subscription;
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            subscription = nextSubscription++;
+            auto next = std::make_unique<Snapshot>(*current.load());
+            if (type >= next->handlers.size())
+            {
+                next->handlers.resize(type + 1);
+            }
+            next->handlers[type].push_back(Entry{subscription, delegate.get()});
+            owned.emplace(subscription, std::move(delegate));
+            retired.emplace_back(current.exchange(next.release()), nullptr);
+        }
+        synchronize();
+        log("Subscribed to event type " + std::to_string(type));
+        return subscription;
+    }
+
+    /**
+     * @brief Removes a subscription. Unless called from a handler of this bus, it returns only
+     * after every publish that could still call the handler has finished.
+     * @return false if there is no such subscription.
+     */
+    bool unsubscribe(SubscriptionId subscription)
+    {
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            auto found = owned.find(subscription);
+            if (found == owned.end())
+            {
+                return false;
+            }
+            auto next = std::make_unique<Snapshot>(*current.load());
+            for (std::vector<Entry> &entries : next->handlers)
+            {
+                for (auto entry = entries.begin(); entry != entries.end(); ++entry)
+                {
+                    if (entry->id == subscription)
+                    {
+                        entries.erase(entry);
+                        break;
+                    }
+                }
+            }
+            retired.emplace_back(current.exchange(next.release()), std::move(found->second));
+            owned.erase(found);
+        }
+        synchronize();
+        log("Unsubscribed " + std::to_string(subscription));
+        return true;
+    }
+
+    /**
+     * @brief Calls every handler subscribed to the type of the event, on the calling thread.
+     * Never blocks; publishing a type nobody subscribed to does nothing.
+     * @param event The event, passed to the handlers by reference.
+     * @throws Exceptions from a handler propagate and skip the remaining handlers.
+     */
+    template <typename Event>
+    void publish(const Event &event)
+    {
+        size_t type = EventBus::typeId<Event>();
+        ReadSection section(*this);
+        const Snapshot *snapshot = current.load();
+        if (type < snapshot->handlers.size())
+        {
+            for (const Entry &entry : snapshot->handlers[type])
+            {
+                (*entry.handler)(&event);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of handlers subscribed to events of type Event.
+     */
+    template <typename Event>
+    size_t subscriberCount() const
+    {
+        size_t type = EventBus::typeId<Event>();
+        ReadSection section(*this);
+        const Snapshot *snapshot = current.load();
+        return type < snapshot->handlers.size() ? snapshot->handlers[type].size() : 0;
+    }
+
+private:
+    using Callback = Delegate<void(const void *)>;
+
+    static constexpr size_t stripeCount = 32; // Reader counters per parity
+
+    struct Entry
+    {
+        SubscriptionId id;
+        const Callback *handler; // Owned by the owned map, later by retired
+    };
+
+    // The handlers of every event type, indexed by EventBus::typeId; never changed once published
+    struct Snapshot
+    {
+        std::vector<std::vector<Entry>> handlers;
+    };
+
+    // A snapshot replaced by a newer one and possibly a removed handler, freed after a grace period
+    using Retired = std::pair<std::unique_ptr<const Snapshot>, std::unique_ptr<Callback>>;
+
+    // Publishes in progress that used one parity, on threads mapped to one stripe
+    struct alignas(64) ReaderCount
+    {
+        std::atomic<size_t> value{0};
+    };
+
+    // Marks a publish in progress; nested ones form a per-thread chain
+    class ReadSection
+    {
+    public:
+        explicit ReadSection(const ConcurrentEventBus &bus) : bus(bus), previous(innermost())
+        {
+            counter = &bus.readers[bus.epoch.load() & 1][stripe()].value;
+            counter->fetch_add(1);
+            innermost() = this;
+        }
+
+        ~ReadSection()
+        {
+            innermost() = previous;
+            counter->fetch_sub(1, std::memory_order_release); // Orders the handler calls before a writer's check
+        }
+
+        ReadSection(const ReadSection &) = delete;
+        ReadSection &operator=(const ReadSection &) = delete;
+
+        // Returns whether the calling thread is publishing on the bus
+        static bool active(const ConcurrentEventBus &bus)
+        {
+            for (const ReadSection *section = innermost(); section; section = section->previous)
+            {
+                if (&section->bus == &bus)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        const ConcurrentEventBus &bus;
+        const ReadSection *previous;
+        std::atomic<size_t> *counter;
+
+        static const ReadSection *&innermost()
+        {
+            thread_local const ReadSection *section = nullptr;
+            return section;
+        }
+
+        static size_t stripe()
+        {
+            thread_local const size_t index = std::hash<std::thread::id>()(std::this_thread::get_id()) % stripeCount;
+            return index;
+        }
+    };
+
+    Logger logger; // Logger instance for logging events
+    std::mutex logMutex; // Serializes logging between threads
+
+    std::atomic<const Snapshot *> current; // Read by publishers without locking
+    mutable ReaderCount readers[2][stripeCount]; // Publishes in progress by epoch parity and stripe
+    std::atomic<unsigned> epoch{0}; // Its parity selects the counters new publishes use
+
+    std::mutex writeMutex; // Serializes snapshot changes; guards the members below
+    SubscriptionId nextSubscription = 1;
+    std::unordered_map<SubscriptionId, std::unique_ptr<Callback>> owned; // The handlers of the current snapshot
+    std::vector<Retired> retired; // Waiting for a grace period
+
+    std::mutex graceMutex; // Serializes grace periods
+
+    void log(const std::string &message)
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        logger.log(message);
+    }
+
+    // Waits until no publish can see a retired snapshot, then frees them. Publishes may have read
+    // the parity just before a flip and counted themselves after it, so both parities are drained
+    // in turn, each after moving new publishes to the other one.
+    void synchronize()
+    {
+        if (ReadSection::active(*this))
+        {
+            return; // Waiting would wait for ourselves
+        }
+        std::lock_guard<std::mutex> grace(graceMutex);
+        std::vector<Retired> expired;
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            expired.swap(retired);
+        }
+        if (expired.empty())
+        {
+            return;
+        }
+        for (int flip = 0; flip < 2; ++flip)
+        {
+            unsigned drained = epoch.fetch_add(1) & 1;
+            for (ReaderCount &count : readers[drained])
+            {
+                while (count.value.load() != 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+};
+
+#endif // CONCURRENTEVENTBUS_HPP
@@ -0,0 +1,736 @@
+#ifndef CSVPARSER_HPP
+#define CSVPARSER_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ThreadPool.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief The CsvTable class holds parsed CSV data column by column.
+ *
+ * Each column has a single inferred type. Integer and floating point columns are stored as plain
+ * vectors (ready to pass to MathOperations); text columns share one character arena per column
+ * with an offset array, so a column of N strings costs two allocations instead of N.
+ */
+class CsvTable
+{
+public:
+    /**
+     * @brief The storage type inferred for a column.
+     */
+    enum class ColumnType : uint8_t
+    {
+        Int64,  // Every field is an integer
+        Double, // Every field is a number; empty fields are stored as NaN
+        String  // Anything else
+    };
+
+    /**
+     * @brief A single typed column.
+     */
+    class Column
+    {
+    public:
+        Column(std::string name, ColumnType type) : columnName(std::move(name)), columnType(type) {}
+
+        const std::string &name() const { return columnName; }
+        ColumnType type() const { return columnType; }
+
+        size_t size() const
+        {
+            switch (columnType)
+            {
+            case ColumnType::Int64: return ints.size();
+            case ColumnType::Double: return doubles.size();
+            default: return offsets.empty() ? 0 : offsets.size() - 1;
+            }
+        }
+
+        /**
+         * @brief Returns the values of an Int64 column.
+         * @throws std::runtime_error if the column has another type.
+         */
+        const std::vector<int64_t> &int64Values() const
+        {
+            expect(ColumnType::Int64, "Int64");
+            return ints;
+        }
+
+        /**
+         * @brief Returns the values of a Double column.
+         * @throws std::runtime_error if the column has another type.
+         */
+        const std::vector<double> &doubleValues() const
+        {
+            expect(ColumnType::Double, "Double");
+            return doubles;
+        }
+
+        /**
+         * @brief Returns the values of a numeric column converted to double, e.g. for MathOperations.
+         * @throws std::runtime_error if the column is a String column.
+         */
+        std::vector<double> toDoubles() const
+        {
+            if (columnType == ColumnType::Double)
+            {
+                return doubles;
+            }
+            expect(ColumnType::Int64, "numeric");
+            return std::vector<double>(ints.begin(), ints.end());
+        }
+
+        /**
+         * @brief Returns the string at the given row of a String column.
+         * @throws std::runtime_error if the column has another type.
+         */
+        std::string_view stringAt(size_t row) const
+        {
+            expect(ColumnType::String, "String");
+            return std::string_view(arena.data() + offsets[row], offsets[row + 1] - offsets[row]);
+        }
+
+        /**
+         * @brief Returns the value at the given row formatted as text, whatever the column type.
+         */
+        std::string textAt(size_t row) const
+        {
+            if (columnType == ColumnType::String)
+            {
+                return std::string(stringAt(row));
+            }
+            if (columnType == ColumnType::Int64)
+            {
+                return std::to_string(ints[row]);
+            }
+            if (std::isnan(doubles[row]))
+            {
+                return std::string();
+            }
+            char buffer[32];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), doubles[row]);
+            return std::string(buffer, result.ptr);
+        }
+
+    private:
+        friend class CsvParser;
+        friend class ColumnarFile;
+
+        std::string columnName;
+        ColumnType columnType;
+        std::vector<int64_t> ints;
+        std::vector<double> doubles;
+        std::string arena;             // Concatenated characters of a String column
+        std::vector<uint64_t> offsets; // Start of each string in the arena, plus the final end
+
+        void expect(ColumnType expected, const char *name) const
+        {
+            if (columnType != expected)
+            {
+                throw std::runtime_error("CSV column '" + columnName + "' is not " + name);
+            }
+        }
+    };
+
+    size_t rowCount() const { return rows; }
+    size_t columnCount() const { return columns.size(); }
+
+    const Column &column(size_t index) const { return columns.at(index); }
+
+    /**
+     * @brief Returns the column with the given header name.
+     * @throws std::out_of_range if there is no such column.
+     */
+    const Column &column(std::string_view name) const
+    {
+        for (const Column &candidate : columns)
+        {
+            if (candidate.name() == name)
+            {
+                return candidate;
+            }
+        }
+        throw std::out_of_range("CSV column not found: " + std::string(name));
+    }
+
+    /**
+     * @brief Flattens the table into "row/column" paths mapped to cell text.
+     * Cells of Int64 and Double columns are formatted from the parsed number, so parse with
+     * inferTypes off when the map must hold each field exactly as written.
+     * @param separator The character placed between the row index and column name.
+     * @return The flattened path to value map.
+     */
+    std::map<std::string, std::string> toPathMap(char separator = '/') const
+    {
+        std::map<std::string, std::string> pathMap;
+        for (size_t row = 0; row < rows; ++row)
+        {
+            std::string prefix = std::to_string(row) + separator;
+            for (const Column &col : columns)
+            {
+                pathMap[prefix + col.name()] = col.textAt(row);
+            }
+        }
+        return pathMap;
+    }
+
+private:
+    friend class CsvParser;
+    friend class ColumnarFile;
+
+    std::vector<Column> columns;
+    size_t rows = 0;
+};
+
+/**
+ * @brief Options controlling the CSV dialect.
+ */
+struct CsvOptions
+{
+    char delimiter = ',';   // Field separator
+    char quote = '"';       // Quote character; doubled inside a quoted field to escape it
+    bool hasHeader = true;  // The first record holds the column names
+    bool inferTypes = true; // Detect Int64/Double columns; otherwise every column is a String
+};
+
+/**
+ * @brief The CsvParser class parses RFC 4180 CSV into a typed, columnar CsvTable.
+ *
+ * Parsing runs in three passes: a SIMD scan (AVX2 or SSE2, scalar fallback) that finds quote,
+ * delimiter and newline positions 64 bytes at a time and masks out those inside quoted fields;
+ * a per-column type inference pass; and materialization into the column arrays. parseParallel
+ * runs the scan over byte ranges and the column passes on a ThreadPool.
+ */
+class CsvParser
+{
+public:
+    /**
+     * @brief Parses CSV text into a table.
+     * @param csv The CSV text.
+     * @param options The dialect options.
+     * @return The parsed table.
+     * @throws std::runtime_error on an unterminated quote or a record with more fields than the header.
+     */
+    static CsvTable parse(std::string_view csv, const CsvOptions &options = CsvOptions())
+    {
+        return materialize(tokenize(csv, options), options);
+    }
+
+    /**
+     * @brief Raw field positions produced by the tokenizer. Fields are stored row after row.
+     */
+    struct Tokens
+    {
+        std::vector<std::string_view> fields; // Raw field text, quotes included
+        std::vector<size_t> rowEnds;          // Index one past the last field of each record
+    };
+
+    /**
+     * @brief Splits CSV text into raw fields and records.
+     * @param csv The CSV text.
+     * @param options The dialect options.
+     * @return The field and record boundaries.
+     * @throws std::runtime_error on an unterminated quoted field.
+     */
+    static Tokens tokenize(std::string_view csv, const CsvOptions &options = CsvOptions())
+    {
+        RangeScan scan = scanRange(csv, 0, csv.size(), false, options);
+        if (scan.endedInQuotes)
+        {
+            throw std::runtime_error("Unterminated quoted CSV field");
+        }
+        return std::move(scan.tokens);
+    }
+
+    /**
+     * @brief Parses CSV text on a thread pool by splitting it into byte ranges.
+     *
+     * Every range is tokenized speculatively as if it started outside a quoted field. The quote
+     * count of each range then gives the real state at every boundary, and only the ranges whose
+     * guess was wrong are tokenized again. The per-range tokens are stitched in order and the
+     * columns are materialized in parallel. Inputs smaller than two ranges are parsed inline.
+     * @param csv The CSV text, typically a MappedFile view.
+     * @param pool The thread pool running the range and column tasks.
+     * @param options The dialect options.
+     * @return The parsed table, identical to parse(csv, options).
+     * @throws std::runtime_error on an unterminated quote or a record with more fields than the header.
+     */
+    static CsvTable parseParallel(std::string_view csv, ThreadPool &pool, const CsvOptions &options = CsvOptions())
+    {
+        size_t rangeCount = std::min(pool.size(), csv.size() / minimumRangeSize);
+        if (rangeCount < 2)
+        {
+            return parse(csv, options);
+        }
+        std::vector<size_t> bounds(rangeCount + 1);
+        for (size_t i = 0; i <= rangeCount; ++i)
+        {
+            bounds[i] = csv.size() / rangeCount * i;
+        }
+        bounds[rangeCount] = csv.size();
+
+        std::vector<std::future<RangeScan>> pending;
+        pending.reserve(rangeCount);
+        for (size_t i = 0; i < rangeCount; ++i)
+        {
+            pending.push_back(pool.submit([csv, &bounds, &options, i]()
+                                          { return scanRange(csv, bounds[i], bounds[i + 1], false, options); }));
+        }
+        std::vector<RangeScan> scans;
+        scans.reserve(rangeCount);
+        for (std::future<RangeScan> &scan : pending)
+        {
+            scans.push_back(scan.get());
+        }
+
+        // Resolve the real quote state at each boundary and rescan the mispredicted ranges. The
+        // input is rejected before any rescan is submitted, since the tasks refer to csv and bounds.
+        std::vector<bool> startsInQuotes(rangeCount);
+        bool inQuotes = false;
+        for (size_t i = 0; i < rangeCount; ++i)
+        {
+            startsInQuotes[i] = inQuotes;
+            inQuotes ^= scans[i].quoteParity;
+        }
+        if (inQuotes)
+        {
+            throw std::runtime_error("Unterminated quoted CSV field");
+        }
+        std::vector<std::pair<size_t, std::future<RangeScan>>> retries;
+        for (size_t i = 0; i < rangeCount; ++i)
+        {
+            if (startsInQuotes[i])
+            {
+                retries.emplace_back(i, pool.submit([csv, &bounds, &options, i]()
+                                                    { return scanRange(csv, bounds[i], bounds[i + 1], true, options); }));
+            }
+        }
+        for (auto &retry : retries)
+        {
+            scans[retry.first] = retry.second.get();
+        }
+
+        Tokens tokens;
+        size_t fieldCount = 0;
+        size_t rowCount = 0;
+        for (const RangeScan &scan : scans)
+        {
+            fieldCount += scan.tokens.fields.size();
+            rowCount += scan.tokens.rowEnds.size();
+        }
+        tokens.fields.reserve(fieldCount);
+        tokens.rowEnds.reserve(rowCount);
+        for (const RangeScan &scan : scans)
+        {
+            size_t base = tokens.fields.size();
+            tokens.fields.insert(tokens.fields.end(), scan.tokens.fields.begin(), scan.tokens.fields.end());
+            for (size_t rowEnd : scan.tokens.rowEnds)
+            {
+                tokens.rowEnds.push_back(base + rowEnd);
+            }
+        }
+        scans.clear();
+        return materialize(tokens, options, &pool);
+    }
+
+    /**
+     * @brief Builds a typed table from tokenized fields.
+     * @param tokens The output of tokenize(); the text it points into must still be alive.
+     * @param options The dialect options.
+     * @param pool Optional thread pool; when given, columns are built in parallel.
+     * @return The parsed table.
+     * @throws std::runtime_error if a record has more fields than the header.
+     */
+    static CsvTable materialize(const Tokens &tokens, const CsvOptions &options = CsvOptions(), ThreadPool *pool = nullptr)
+    {
+        CsvTable table;
+        if (tokens.rowEnds.empty())
+        {
+            return table;
+        }
+        size_t firstRow = options.hasHeader ? 1 : 0;
+        size_t columnCount = tokens.rowEnds[0];
+        table.rows = tokens.rowEnds.size() - firstRow;
+
+        for (size_t row = firstRow; row < tokens.rowEnds.size(); ++row)
+        {
+            size_t start = row == 0 ? 0 : tokens.rowEnds[row - 1];
+            if (tokens.rowEnds[row] - start > columnCount)
+            {
+                throw std::runtime_error("CSV record " + std::to_string(row + 1) + " has more fields than the header");
+            }
+        }
+
+        table.columns.reserve(columnCount);
+        if (!pool)
+        {
+            for (size_t col = 0; col < columnCount; ++col)
+            {
+                table.columns.push_back(buildColumn(tokens, firstRow, col, options));
+            }
+            return table;
+        }
+        std::vector<std::future<CsvTable::Column>> pending;
+        pending.reserve(columnCount);
+        for (size_t col = 0; col < columnCount; ++col)
+        {
+            pending.push_back(pool->submit([&tokens, &options, firstRow, col]()
+                                           { return buildColumn(tokens, firstRow, col, options); }));
+        }
+        for (std::future<CsvTable::Column> &column : pending)
+        {
+            table.columns.push_back(column.get());
+        }
+        return table;
+    }
+
+private:
+    using ColumnType = CsvTable::ColumnType;
+
+    static constexpr size_t minimumRangeSize = 1 << 20; // Smallest byte range worth a parallel task
+
+    /**
+     * @brief Tokens of one byte range plus what is needed to stitch ranges together.
+     */
+    struct RangeScan
+    {
+        Tokens tokens;
+        bool quoteParity = false;   // Odd number of quote characters in [begin, end)
+        bool endedInQuotes = false; // The input ended inside a quoted field
+    };
+
+    /**
+     * @brief Tokenizes the records that start in [begin, end).
+     *
+     * A range other than the first skips ahead to the first record boundary, then keeps reading
+     * past end until the last record it owns is complete.
+     * @param inQuotes The quote state assumed at begin.
+     */
+    static RangeScan scanRange(std::string_view csv, size_t begin, size_t end, bool inQuotes, const CsvOptions &options)
+    {
+        RangeScan scan;
+        Tokens &tokens = scan.tokens;
+        tokens.fields.reserve((end - begin) / 8 + 1);
+        bool skipping = begin != 0 && (inQuotes || csv[begin - 1] != '\n');
+        size_t fieldStart = begin;
+        size_t offset = begin;
+        char lastBlock[64];
+        while (offset < csv.size())
+        {
+            const char *block = csv.data() + offset;
+            size_t blockSize = std::min<size_t>(64, csv.size() - offset);
+            if (blockSize < 64)
+            {
+                std::memset(lastBlock, 0, sizeof(lastBlock));
+                std::memcpy(lastBlock, block, blockSize);
+                block = lastBlock;
+            }
+            uint64_t quotes = matchMask(block, options.quote);
+            uint64_t separators = matchMask(block, options.delimiter) | matchMask(block, '\n');
+            if (blockSize < 64)
+            {
+                uint64_t valid = (uint64_t(1) << blockSize) - 1;
+                quotes &= valid;
+                separators &= valid;
+            }
+            if (offset < end)
+            {
+                uint64_t owned = end - offset >= 64 ? ~uint64_t(0) : (uint64_t(1) << (end - offset)) - 1;
+                scan.quoteParity ^= (popCount(quotes & owned) & 1) != 0;
+            }
+            uint64_t quoted = prefixXor(quotes) ^ (inQuotes ? ~uint64_t(0) : 0);
+            inQuotes = (quoted >> 63) & 1;
+            separators &= ~quoted;
+            while (separators)
+            {
+                size_t position = offset + static_cast<size_t>(countTrailingZeros(separators));
+                bool newline = csv[position] == '\n';
+                if (!skipping)
+                {
+                    tokens.fields.push_back(trimCarriageReturn(csv.substr(fieldStart, position - fieldStart)));
+                    if (newline)
+                    {
+                        endRecord(tokens);
+                    }
+                }
+                if (newline)
+                {
+                    skipping = false;
+                    if (position + 1 >= end)
+                    {
+                        return scan; // The next record belongs to the following range
+                    }
+                }
+                fieldStart = position + 1;
+                separators &= separators - 1;
+            }
+            offset += 64;
+        }
+        scan.endedInQuotes = inQuotes;
+        // A record cut off by the end of the input, including one whose last field is empty
+        // because the input ends in a delimiter
+        bool endsInDelimiter = fieldStart == csv.size() && fieldStart > begin && csv.back() == options.delimiter;
+        if (!skipping && (fieldStart < csv.size() || endsInDelimiter))
+        {
+            tokens.fields.push_back(trimCarriageReturn(csv.substr(fieldStart)));
+            endRecord(tokens);
+        }
+        return scan;
+    }
+
+    static CsvTable::Column buildColumn(const Tokens &tokens, size_t firstRow, size_t col, const CsvOptions &options)
+    {
+        std::string name = options.hasHeader ? decodeField(tokens.fields[col], options.quote) : std::to_string(col);
+        ColumnType type = options.inferTypes ? inferType(tokens, firstRow, col, options) : ColumnType::String;
+        CsvTable::Column column(std::move(name), type);
+        fillColumn(column, tokens, firstRow, col, options);
+        return column;
+    }
+
+    static void endRecord(Tokens &tokens)
+    {
+        size_t start = tokens.rowEnds.empty() ? 0 : tokens.rowEnds.back();
+        // A line holding one empty field is a blank line, not a record
+        if (tokens.fields.size() - start == 1 && tokens.fields.back().empty())
+        {
+            tokens.fields.pop_back();
+            return;
+        }
+        tokens.rowEnds.push_back(tokens.fields.size());
+    }
+
+    static std::string_view trimCarriageReturn(std::string_view field)
+    {
+        if (!field.empty() && field.back() == '\r')
+        {
+            field.remove_suffix(1);
+        }
+        return field;
+    }
+
+    // Returns the raw field of a record, or an empty view for records shorter than the header.
+    static std::string_view fieldAt(const Tokens &tokens, size_t row, size_t col)
+    {
+        size_t start = row == 0 ? 0 : tokens.rowEnds[row - 1];
+        size_t index = start + col;
+        return index < tokens.rowEnds[row] ? tokens.fields[index] : std::string_view();
+    }
+
+    static bool isQuoted(std::string_view field, char quote)
+    {
+        return field.size() >= 2 && field.front() == quote && field.back() == quote;
+    }
+
+    /**
+     * @brief Removes the surrounding quotes of a field and collapses doubled quotes.
+     */
+    static std::string decodeField(std::string_view field, char quote)
+    {
+        if (!isQuoted(field, quote))
+        {
+            return std::string(field);
+        }
+        field = field.substr(1, field.size() - 2);
+        std::string decoded;
+        decoded.reserve(field.size());
+        for (size_t i = 0; i < field.size(); ++i)
+        {
+            decoded.push_back(field[i]);
+            if (field[i] == quote && i + 1 < field.size() && field[i + 1] == quote)
+            {
+                ++i;
+            }
+        }
+        return decoded;
+    }
+
+    static bool parseInt(std::string_view text, int64_t &value)
+    {
+        if (!text.empty() && text.front() == '+')
+            text.remove_prefix(1);
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    static bool parseDouble(std::string_view text, double &value)
+    {
+        if (!text.empty() && text.front() == '+')
+            text.remove_prefix(1);
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    static ColumnType inferType(const Tokens &tokens, size_t firstRow, size_t col, const CsvOptions &options)
+    {
+        bool allInts = true;
+        bool anyValue = false;
+        for (size_t row = firstRow; row < tokens.rowEnds.size(); ++row)
+        {
+            std::string_view field = fieldAt(tokens, row, col);
+            if (isQuoted(field, options.quote))
+            {
+                return ColumnType::String;
+            }
+            if (field.empty())
+            {
+                allInts = false; // Integers have no missing-value marker; fall back to NaN doubles
+                continue;
+            }
+            anyValue = true;
+            int64_t intValue;
+            double doubleValue;
+            if (allInts && parseInt(field, intValue))
+            {
+                continue;
+            }
+            allInts = false;
+            if (!parseDouble(field, doubleValue))
+            {
+                return ColumnType::String;
+            }
+        }
+        if (!anyValue)
+        {
+            return ColumnType::String;
+        }
+        return allInts ? ColumnType::Int64 : ColumnType::Double;
+    }
+
+    static void fillColumn(CsvTable::Column &column, const Tokens &tokens, size_t firstRow, size_t col, const CsvOptions &options)
+    {
+        size_t count = tokens.rowEnds.size() - firstRow;
+        switch (column.columnType)
+        {
+        case ColumnType::Int64:
+            column.ints.resize(count);
+            for (size_t row = firstRow; row < tokens.rowEnds.size(); ++row)
+            {
+                parseInt(fieldAt(tokens, row, col), column.ints[row - firstRow]);
+            }
+            break;
+        case ColumnType::Double:
+            column.doubles.resize(count);
+            for (size_t row = firstRow; row < tokens.rowEnds.size(); ++row)
+            {
+                double &value = column.doubles[row - firstRow];
+                if (!parseDouble(fieldAt(tokens, row, col), value))
+                {
+                    value = std::numeric_limits<double>::quiet_NaN();
+                }
+            }
+            break;
+        case ColumnType::String:
+        {
+            size_t bytes = 0;
+            for (size_t row = firstRow; row < tokens.rowEnds.size(); ++row)
+            {
+                bytes += fieldAt(tokens, row, col).size();
+            }
+            column.arena.reserve(bytes);
+            column.offsets.reserve(count + 1);
+            column.offsets.push_back(0);
+            for (size_t row = firstRow; row < tokens.rowEnds.size(); ++row)
+            {
+                std::string_view field = fieldAt(tokens, row, col);
+                if (isQuoted(field, options.quote))
+                    column.arena += decodeField(field, options.quote);
+                else
+                    column.arena.append(field.data(), field.size());
+                column.offsets.push_back(column.arena.size());
+            }
+            break;
+        }
+        }
+    }
+
+#if defined(__AVX2__)
+    static uint64_t matchMask(const char *block, char c)
+    {
+        __m256i needle = _mm256_set1_epi8(c);
+        uint64_t low = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(block)), needle)));
+        uint64_t high = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32)), needle)));
+        return low | (high << 32);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    static uint64_t matchMask(const char *block, char c)
+    {
+        __m128i needle = _mm_set1_epi8(c);
+        uint64_t mask = 0;
+        for (int quarter = 0; quarter < 4; ++quarter)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + quarter * 16));
+            mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)))) << (quarter * 16);
+        }
+        return mask;
+    }
+#else
+    static uint64_t matchMask(const char *block, char c)
+    {
+        uint64_t mask = 0;
+        for (int i = 0; i < 64; ++i)
+        {
+            mask |= static_cast<uint64_t>(block[i] == c) << i;
+        }
+        return mask;
+    }
+#endif
+
+    // Inclusive prefix XOR: bit i is set while inside a quoted section. Doubled quotes cancel out.
+    static uint64_t prefixXor(uint64_t bits)
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    static int popCount(uint64_t bits)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(bits);
+#else
+        int count = 0;
+        for (; bits; bits &= bits - 1)
+        {
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    static int countTrailingZeros(uint64_t bits)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(bits);
+#else
+        int count = 0;
+        while (!(bits & 1))
+        {
+            bits >>= 1;
+            ++count;
+        }
+        return count;
+#endif
+    }
+};
+
+#endif // CSVPARSER_HPP
@@ -0,0 +1,141 @@
+#ifndef DELEGATE_HPP
+#define DELEGATE_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature>
+class Delegate;
+
+/**
+ * @brief The Delegate class is a move-only callable wrapper with small-buffer storage.
+ *
+ * Unlike std::function, callables of up to inlineSize bytes (a lambda capturing a few references
+ * or pointers, a function pointer) are stored inside the delegate itself, so creating one never
+ * allocates; only larger callables, or ones whose move constructor may throw, go to the heap.
+ * Calling costs one indirect call, and the callable is inlined into it.
+ */
+template <typename Result, typename... Args>
+class Delegate<Result(Args...)>
+{
+public:
+    static constexpr size_t inlineSize = 4 * sizeof(void *); // Callables up to this size are stored in place
+
+    Delegate() = default;
+
+    /**
+     * @brief Wraps a callable, e.g. a lambda or a function pointer.
+     */
+    template <typename Callable, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, Delegate>>>
+    Delegate(Callable &&callable)
+    {
+        using Stored = std::decay_t<Callable>;
+        if constexpr (fitsInline<Stored>())
+        {
+            ::new (static_cast<void *>(storage)) Stored(std::forward<Callable>(callable));
+            invoker = [](void *target, Args... args) -> Result
+            { return (*static_cast<Stored *>(target))(std::forward<Args>(args)...); };
+            relocate = [](void *destination, void *source)
+            {
+                Stored *callable = static_cast<Stored *>(source);
+                if (destination)
+                {
+                    ::new (destination) Stored(std::move(*callable));
+                }
+                callable->~Stored();
+            };
+        }
+        else
+        {
+            *reinterpret_cast<Stored **>(storage) = new Stored(std::forward<Callable>(callable));
+            invoker = [](void *target, Args... args) -> Result
+            { return (**static_cast<Stored **>(target))(std::forward<Args>(args)...); };
+            relocate = [](void *destination, void *source)
+            {
+                Stored **callable = static_cast<Stored **>(source);
+                if (destination)
+                {
+                    *static_cast<Stored **>(destination) = *callable;
+                }
+                else
+                {
+                    delete *callable;
+                }
+            };
+        }
+    }
+
+    Delegate(Delegate &&other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    Delegate &operator=(Delegate &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    Delegate(const Delegate &) = delete;
+    Delegate &operator=(const Delegate &) = delete;
+
+    ~Delegate()
+    {
+        reset();
+    }
+
+    /**
+     * @brief Calls the wrapped callable; the delegate must not be empty.
+     */
+    Result operator()(Args... args) const
+    {
+        return invoker(storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return invoker != nullptr; }
+
+    /**
+     * @brief Returns whether a callable of type Callable would be stored without allocating.
+     */
+    template <typename Callable>
+    static constexpr bool fitsInline()
+    {
+        return sizeof(Callable) <= inlineSize && alignof(Callable) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Callable>;
+    }
+
+private:
+    alignas(std::max_align_t) mutable unsigned char storage[inlineSize];
+    Result (*invoker)(void *, Args...) = nullptr;
+    void (*relocate)(void *, void *) = nullptr; // Moves the callable to the first buffer, or destroys it if that is null
+
+    void moveFrom(Delegate &other)
+    {
+        if (other.invoker)
+        {
+            other.relocate(storage, other.storage);
+            invoker = other.invoker;
+            relocate = other.relocate;
+            other.invoker = nullptr;
+            other.relocate = nullptr;
+        }
+    }
+
+    void reset()
+    {
+        if (invoker)
+        {
+            relocate(nullptr, storage);
+            invoker = nullptr;
+            relocate = nullptr;
+        }
+    }
+};
+
+#endif // DELEGATE_HPP
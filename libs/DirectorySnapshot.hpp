@@ -0,0 +1,373 @@
+#ifndef DIRECTORYSNAPSHOT_HPP
+#define DIRECTORYSNAPSHOT_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "ThreadPool.hpp"
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ * @brief The DirectorySnapshot class records the state (inode, size, modification time) of every
+ * entry below a directory, so two snapshots can be compared to find what changed.
+ *
+ * Entries are kept in one vector sorted by path, with all relative paths packed into a single
+ * string, which keeps a snapshot of 100k files to a few megabytes and lets diff() compare two
+ * snapshots in one merge pass. Symbolic links are recorded but not followed. Capturing can spread
+ * the directory listing over a ThreadPool, one task per directory.
+ */
+class DirectorySnapshot
+{
+public:
+    /**
+     * @brief The recorded state of one entry.
+     */
+    struct Entry
+    {
+        uint64_t inode = 0;      // 0 where the platform has no inode numbers
+        uint64_t size = 0;       // 0 for directories
+        int64_t modified = 0;    // Modification time in nanoseconds
+        uint32_t pathOffset = 0; // Start of the relative path in the packed path string
+        uint32_t pathLength = 0;
+        bool isDirectory = false;
+    };
+
+    enum class Change
+    {
+        Created,
+        Modified,
+        Deleted,
+        Renamed
+    };
+
+    DirectorySnapshot() = default;
+
+    /**
+     * @brief Records the entries of a directory.
+     * @param root The directory; it is not itself part of the snapshot.
+     * @param recursive Whether subdirectories are descended into.
+     * @param pool If given, directories are listed in parallel on it; it must not be the pool the
+     * calling thread belongs to.
+     * @param onDirectory If given, called with the full path of each subdirectory just before it is
+     * listed (on the pool's threads when there is a pool), e.g. to start watching it.
+     * @return The snapshot; unreadable directories are skipped.
+     */
+    static DirectorySnapshot capture(const std::string &root, bool recursive, ThreadPool *pool = nullptr,
+                                     const std::function<void(const std::string &)> &onDirectory = nullptr)
+    {
+        Collector collector(root, recursive, pool, onDirectory);
+        if (pool)
+        {
+            collector.spawn(std::string());
+            std::unique_lock<std::mutex> lock(collector.mutex);
+            collector.finished.wait(lock, [&]()
+                                    { return collector.pending == 0; });
+        }
+        else
+        {
+            std::vector<std::string> stack{std::string()};
+            while (!stack.empty())
+            {
+                std::string relative = std::move(stack.back());
+                stack.pop_back();
+                if (onDirectory && !relative.empty())
+                {
+                    onDirectory(root + '/' + relative);
+                }
+                Listing listing = listDirectory(root, relative, recursive);
+                for (std::string &subdirectory : listing.subdirectories)
+                {
+                    stack.push_back(std::move(subdirectory));
+                }
+                collector.listings.push_back(std::move(listing));
+            }
+        }
+        return merge(root, collector.listings);
+    }
+
+    const std::string &root() const { return rootPath; }
+    size_t size() const { return entries.size(); }
+    const Entry &entry(size_t index) const { return entries[index]; }
+
+    /**
+     * @brief Returns the path of an entry relative to the root, with '/' separators.
+     */
+    std::string_view path(size_t index) const
+    {
+        return std::string_view(paths).substr(entries[index].pathOffset, entries[index].pathLength);
+    }
+
+    /**
+     * @brief Returns the root joined with the relative path of an entry.
+     */
+    std::string fullPath(size_t index) const
+    {
+        return rootPath + '/' + std::string(path(index));
+    }
+
+    /**
+     * @brief Reports the differences between two snapshots of the same root.
+     *
+     * Files whose size, modification time or inode changed are Modified (directories are never
+     * Modified). An entry that disappeared and one that appeared with the same inode, type, size
+     * and modification time are reported together as Renamed. Modified changes come first, then
+     * deletions, then creations and renames, each in path order.
+     * @param before The older snapshot.
+     * @param after The newer snapshot.
+     * @param visit Called as visit(Change, const std::string &path, const std::string &oldPath,
+     * bool isDirectory) with full paths; oldPath is empty except for Renamed.
+     */
+    template <typename Visitor>
+    static void diff(const DirectorySnapshot &before, const DirectorySnapshot &after, Visitor &&visit)
+    {
+        std::vector<size_t> created;
+        std::vector<size_t> deleted;
+        size_t i = 0;
+        size_t j = 0;
+        while (i < before.size() || j < after.size())
+        {
+            int order = i == before.size() ? 1 : j == after.size() ? -1 : before.path(i).compare(after.path(j));
+            if (order < 0)
+            {
+                deleted.push_back(i++);
+                continue;
+            }
+            if (order > 0)
+            {
+                created.push_back(j++);
+                continue;
+            }
+            const Entry &old = before.entry(i);
+            const Entry &now = after.entry(j);
+            if (old.isDirectory != now.isDirectory)
+            {
+                deleted.push_back(i);
+                created.push_back(j);
+            }
+            else if (!now.isDirectory && (old.size != now.size || old.modified != now.modified || old.inode != now.inode))
+            {
+                visit(Change::Modified, after.fullPath(j), std::string(), false);
+            }
+            ++i;
+            ++j;
+        }
+
+        std::unordered_map<uint64_t, size_t> deletedByInode;
+        for (size_t index : deleted)
+        {
+            if (before.entry(index).inode != 0)
+            {
+                deletedByInode.emplace(before.entry(index).inode, index);
+            }
+        }
+        std::vector<size_t> renamedFrom(created.size(), SIZE_MAX);
+        std::vector<bool> renamed(before.size(), false);
+        for (size_t k = 0; k < created.size(); ++k)
+        {
+            const Entry &now = after.entry(created[k]);
+            auto match = now.inode != 0 ? deletedByInode.find(now.inode) : deletedByInode.end();
+            if (match == deletedByInode.end())
+            {
+                continue;
+            }
+            const Entry &old = before.entry(match->second);
+            if (old.isDirectory == now.isDirectory && old.size == now.size && old.modified == now.modified)
+            {
+                renamedFrom[k] = match->second;
+                renamed[match->second] = true;
+                deletedByInode.erase(match);
+            }
+        }
+        for (size_t index : deleted)
+        {
+            if (!renamed[index])
+            {
+                visit(Change::Deleted, before.fullPath(index), std::string(), before.entry(index).isDirectory);
+            }
+        }
+        for (size_t k = 0; k < created.size(); ++k)
+        {
+            const Entry &now = after.entry(created[k]);
+            if (renamedFrom[k] != SIZE_MAX)
+            {
+                visit(Change::Renamed, after.fullPath(created[k]), before.fullPath(renamedFrom[k]), now.isDirectory);
+            }
+            else
+            {
+                visit(Change::Created, after.fullPath(created[k]), std::string(), now.isDirectory);
+            }
+        }
+    }
+
+private:
+    std::string rootPath;
+    std::vector<Entry> entries; // Sorted by path
+    std::string paths;          // All relative paths, back to back
+
+    // The entries of one directory, with offsets into its own path string
+    struct Listing
+    {
+        std::vector<Entry> entries;
+        std::string paths;
+        std::vector<std::string> subdirectories; // Relative paths still to be listed
+    };
+
+    // Shared state of a parallel capture
+    struct Collector
+    {
+        const std::string &root;
+        bool recursive;
+        ThreadPool *pool;
+        const std::function<void(const std::string &)> &onDirectory;
+        std::mutex mutex;
+        std::condition_variable finished;
+        size_t pending = 0;
+        std::vector<Listing> listings;
+
+        Collector(const std::string &root, bool recursive, ThreadPool *pool, const std::function<void(const std::string &)> &onDirectory)
+            : root(root), recursive(recursive), pool(pool), onDirectory(onDirectory) {}
+
+        void spawn(std::string relative)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++pending;
+            }
+            pool->submit([this, relative = std::move(relative)]()
+                         {
+                if (onDirectory && !relative.empty())
+                {
+                    onDirectory(root + '/' + relative);
+                }
+                Listing listing = listDirectory(root, relative, recursive);
+                for (std::string &subdirectory : listing.subdirectories)
+                {
+                    spawn(std::move(subdirectory));
+                }
+                listing.subdirectories.clear();
+                std::lock_guard<std::mutex> lock(mutex);
+                listings.push_back(std::move(listing));
+                if (--pending == 0)
+                {
+                    finished.notify_all();
+                } });
+        }
+    };
+
+    static void addEntry(Listing &listing, const std::string &relative, Entry entry)
+    {
+        entry.pathOffset = static_cast<uint32_t>(listing.paths.size());
+        entry.pathLength = static_cast<uint32_t>(relative.size());
+        listing.paths += relative;
+        listing.entries.push_back(entry);
+        if (entry.isDirectory)
+        {
+            listing.subdirectories.push_back(relative);
+        }
+    }
+
+    static Listing listDirectory(const std::string &root, const std::string &relative, bool recursive)
+    {
+        Listing listing;
+        std::string directory = relative.empty() ? root : root + '/' + relative;
+        std::string prefix = relative.empty() ? std::string() : relative + '/';
+#ifdef _WIN32
+        std::error_code error;
+        for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+        {
+            std::error_code statusError;
+            Entry entry;
+            entry.isDirectory = it->is_directory(statusError) && !it->is_symlink(statusError);
+            entry.size = entry.isDirectory ? 0 : it->file_size(statusError);
+            entry.modified = std::chrono::duration_cast<std::chrono::nanoseconds>(it->last_write_time(statusError).time_since_epoch()).count();
+            addEntry(listing, prefix + it->path().filename().string(), entry);
+        }
+#else
+        DIR *handle = ::opendir(directory.c_str());
+        if (!handle)
+        {
+            return listing;
+        }
+        int descriptor = ::dirfd(handle);
+        while (dirent *item = ::readdir(handle))
+        {
+            if (std::strcmp(item->d_name, ".") == 0 || std::strcmp(item->d_name, "..") == 0)
+            {
+                continue;
+            }
+            struct stat status;
+            if (::fstatat(descriptor, item->d_name, &status, AT_SYMLINK_NOFOLLOW) != 0)
+            {
+                continue; // Removed since readdir
+            }
+            Entry entry;
+            entry.inode = static_cast<uint64_t>(status.st_ino);
+            entry.isDirectory = S_ISDIR(status.st_mode);
+            entry.size = entry.isDirectory ? 0 : static_cast<uint64_t>(status.st_size);
+            entry.modified = static_cast<int64_t>(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec;
+            addEntry(listing, prefix + item->d_name, entry);
+        }
+        ::closedir(handle);
+#endif
+        if (!recursive)
+        {
+            listing.subdirectories.clear();
+        }
+        return listing;
+    }
+
+    static DirectorySnapshot merge(const std::string &root, std::vector<Listing> &listings)
+    {
+        struct Source
+        {
+            std::string_view path;
+            const Entry *entry;
+        };
+        std::vector<Source> sources;
+        size_t totalPaths = 0;
+        for (const Listing &listing : listings)
+        {
+            for (const Entry &entry : listing.entries)
+            {
+                sources.push_back({std::string_view(listing.paths).substr(entry.pathOffset, entry.pathLength), &entry});
+            }
+            totalPaths += listing.paths.size();
+        }
+        if (totalPaths > UINT32_MAX)
+        {
+            throw std::length_error("Directory snapshot paths exceed 4 GiB");
+        }
+        std::sort(sources.begin(), sources.end(), [](const Source &a, const Source &b)
+                  { return a.path < b.path; });
+
+        DirectorySnapshot snapshot;
+        snapshot.rootPath = root;
+        snapshot.entries.reserve(sources.size());
+        snapshot.paths.reserve(totalPaths);
+        for (const Source &source : sources)
+        {
+            Entry entry = *source.entry;
+            entry.pathOffset = static_cast<uint32_t>(snapshot.paths.size());
+            snapshot.paths.append(source.path);
+            snapshot.entries.push_back(entry);
+        }
+        return snapshot;
+    }
+};
+
+#endif // DIRECTORYSNAPSHOT_HPP
@@ -0,0 +1,413 @@
+#ifndef DOCUMENT_HPP
+#define DOCUMENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MonotonicArena.hpp"
+
+/**
+ * @brief The Document class is the tree produced by the structured parsers (JSON and friends).
+ *
+ * Nodes are stored in a single contiguous array in document order (a "tape"): every container
+ * records the index one past its last descendant, so skipping a subtree is a single jump and
+ * traversal never chases pointers. Object members keep their key on the child node, which allows
+ * repeated keys and preserves the original member order.
+ *
+ * The tape and all strings live in a MonotonicArena owned by the document, so building a document
+ * costs a handful of allocations regardless of its size and destroying it frees everything at
+ * once. Keys and text are string_views: either into the arena, or directly into the parsed input
+ * when the builder was asked to parse in place (see retainSource()).
+ */
+class Document
+{
+public:
+    /**
+     * @brief The kind of value stored in a node.
+     */
+    enum class Type : uint8_t
+    {
+        Null,
+        Boolean,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    /**
+     * @brief A single entry of the tape.
+     */
+    struct Node
+    {
+        Type type = Type::Null;
+        uint32_t size = 0;     // Number of direct children for arrays and objects
+        uint32_t next = 0;     // Index one past the last node of this subtree
+        double number = 0.0;   // Parsed value for numbers, 1 or 0 for booleans
+        std::string_view key;  // Member name when the parent is an object
+        std::string_view text; // Decoded string, or the literal text of numbers and booleans
+    };
+
+    /**
+     * @brief A lightweight read-only handle to a node of a Document.
+     * Values stay valid for as long as the owning Document is alive and unmodified.
+     */
+    class Value
+    {
+    public:
+        /**
+         * @brief Forward iterator over the direct children of an array or object.
+         */
+        class Iterator
+        {
+        public:
+            Iterator(const Document *document, size_t index) : document(document), index(index) {}
+            Value operator*() const { return Value(document, index); }
+            Iterator &operator++()
+            {
+                index = document->nodes[index].next;
+                return *this;
+            }
+            bool operator==(const Iterator &other) const { return index == other.index; }
+            bool operator!=(const Iterator &other) const { return index != other.index; }
+
+        private:
+            const Document *document;
+            size_t index;
+        };
+
+        Value(const Document *document, size_t index) : document(document), index(index) {}
+
+        Type type() const { return node().type; }
+        bool isNull() const { return type() == Type::Null; }
+        bool isBool() const { return type() == Type::Boolean; }
+        bool isNumber() const { return type() == Type::Number; }
+        bool isString() const { return type() == Type::String; }
+        bool isArray() const { return type() == Type::Array; }
+        bool isObject() const { return type() == Type::Object; }
+
+        /**
+         * @brief Returns the member name of this value (empty for array elements and the root).
+         */
+        std::string_view key() const { return node().key; }
+
+        /**
+         * @brief Returns the decoded string, or the literal text of a number, boolean or null.
+         */
+        std::string_view text() const { return node().text; }
+
+        /**
+         * @brief Returns the string value.
+         * @throws std::runtime_error if the value is not a string.
+         */
+        std::string_view asString() const
+        {
+            expect(Type::String, "string");
+            return node().text;
+        }
+
+        /**
+         * @brief Returns the numeric value.
+         * @throws std::runtime_error if the value is not a number.
+         */
+        double asNumber() const
+        {
+            expect(Type::Number, "number");
+            return node().number;
+        }
+
+        /**
+         * @brief Returns the boolean value.
+         * @throws std::runtime_error if the value is not a boolean.
+         */
+        bool asBool() const
+        {
+            expect(Type::Boolean, "boolean");
+            return node().number != 0.0;
+        }
+
+        /**
+         * @brief Returns the number of direct children (0 for scalars).
+         */
+        size_t size() const { return node().size; }
+
+        Iterator begin() const { return Iterator(document, index + 1); }
+        Iterator end() const { return Iterator(document, node().next); }
+
+        /**
+         * @brief Returns the child at the given position of an array or object.
+         * @throws std::out_of_range if the position is past the last child.
+         */
+        Value operator[](size_t position) const
+        {
+            if (position >= size())
+            {
+                throw std::out_of_range("Document index out of range: " + std::to_string(position));
+            }
+            Iterator it = begin();
+            for (size_t i = 0; i < position; ++i)
+            {
+                ++it;
+            }
+            return *it;
+        }
+
+        /**
+         * @brief Returns the first member of an object with the given key.
+         * @throws std::out_of_range if there is no such member.
+         */
+        Value operator[](std::string_view memberKey) const
+        {
+            std::optional<Value> member = find(memberKey);
+            if (!member)
+            {
+                throw std::out_of_range("Document key not found: " + std::string(memberKey));
+            }
+            return *member;
+        }
+
+        /**
+         * @brief Finds the first member of an object with the given key.
+         * @return The member, or std::nullopt if it does not exist or this is not an object.
+         */
+        std::optional<Value> find(std::string_view memberKey) const
+        {
+            if (!isObject())
+            {
+                return std::nullopt;
+            }
+            for (Value child : *this)
+            {
+                if (child.key() == memberKey)
+                {
+                    return child;
+                }
+            }
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Returns the position of this value on the document tape.
+         */
+        size_t nodeIndex() const { return index; }
+
+    private:
+        const Document *document;
+        size_t index;
+
+        const Node &node() const { return document->nodes[index]; }
+
+        void expect(Type expected, const char *name) const
+        {
+            if (type() != expected)
+            {
+                throw std::runtime_error(std::string("Document value is not a ") + name);
+            }
+        }
+    };
+
+    /**
+     * @brief Returns the root value.
+     * @throws std::runtime_error if the document is empty.
+     */
+    Value root() const
+    {
+        if (count == 0)
+        {
+            throw std::runtime_error("Document is empty");
+        }
+        return Value(this, 0);
+    }
+
+    Document() = default;
+    Document(const Document &) = delete;
+    Document &operator=(const Document &) = delete;
+
+    Document(Document &&other) noexcept { takeFrom(other); }
+
+    Document &operator=(Document &&other) noexcept
+    {
+        if (this != &other)
+        {
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    bool empty() const { return count == 0; }
+    size_t nodeCount() const { return count; }
+
+    /**
+     * @brief Returns the raw tape entry at the given index, for code that walks the tape directly.
+     */
+    const Node &nodeAt(size_t index) const { return nodes[index]; }
+
+    /**
+     * @brief Returns the arena holding the tape and the copied strings.
+     */
+    const MonotonicArena &memoryArena() const { return arena; }
+
+    /**
+     * @brief Reserves tape capacity, e.g. from the structural count of the input.
+     */
+    void reserve(size_t nodeCount)
+    {
+        if (nodeCount > capacity)
+        {
+            grow(nodeCount);
+        }
+    }
+
+    /**
+     * @brief Copies text into the document's arena.
+     * @return A view that stays valid for the lifetime of the document.
+     */
+    std::string_view store(std::string_view text) { return arena.copy(text); }
+
+    /**
+     * @brief Allocates uninitialized bytes in the document's arena, e.g. for decoding text in place.
+     */
+    char *allocateText(size_t bytes) { return static_cast<char *>(arena.allocate(bytes, 1)); }
+
+    /**
+     * @brief Keeps the buffer that in-place keys and text point into alive as long as the document.
+     * @param owner Shared ownership of the parsed input, e.g. a MappedFile.
+     */
+    void retainSource(std::shared_ptr<const void> owner) { source = std::move(owner); }
+
+    /**
+     * @brief Appends an array or object node; children are appended until closeContainer is called.
+     * @param key The member name; it must outlive the document (see store()).
+     * @return The tape index of the new container.
+     */
+    size_t openContainer(Type type, std::string_view key = {})
+    {
+        size_t index = append(type, key, {}, 0.0);
+        openContainers.push_back(static_cast<uint32_t>(index));
+        return index;
+    }
+
+    /**
+     * @brief Closes the innermost open container.
+     * @throws std::logic_error if no container is open.
+     */
+    void closeContainer()
+    {
+        if (openContainers.empty())
+        {
+            throw std::logic_error("Document has no open container");
+        }
+        nodes[openContainers.back()].next = static_cast<uint32_t>(count);
+        openContainers.pop_back();
+    }
+
+    /**
+     * @brief Appends a scalar (null, boolean, number or string) node.
+     * @param key The member name; it must outlive the document (see store()).
+     * @param text The value text; it must outlive the document (see store()).
+     */
+    void addScalar(Type type, std::string_view key, std::string_view text, double number = 0.0)
+    {
+        size_t index = append(type, key, text, number);
+        nodes[index].next = static_cast<uint32_t>(index + 1);
+    }
+
+    /**
+     * @brief Flattens the document into "parent/child" paths mapped to scalar text.
+     * Array elements use their position as the path segment, so repeated keys never collide.
+     * @param separator The character placed between path segments.
+     * @return The flattened path to value map.
+     */
+    std::map<std::string, std::string> toPathMap(char separator = '/') const
+    {
+        std::map<std::string, std::string> pathMap;
+        if (count > 0)
+        {
+            flatten(0, "", separator, pathMap);
+        }
+        return pathMap;
+    }
+
+private:
+    MonotonicArena arena;                 // Owns the tape and all copied strings
+    Node *nodes = nullptr;                // The tape, in document order
+    size_t count = 0;                     // Nodes in use
+    size_t capacity = 0;                  // Nodes allocated
+    std::vector<uint32_t> openContainers; // Containers still receiving children while building
+    std::shared_ptr<const void> source;   // Input buffer referenced by in-place strings, if any
+
+    size_t append(Type type, std::string_view key, std::string_view text, double number)
+    {
+        if (count == capacity)
+        {
+            grow(capacity < 64 ? 64 : capacity * 2);
+        }
+        if (!openContainers.empty())
+        {
+            ++nodes[openContainers.back()].size;
+        }
+        Node &node = nodes[count];
+        node.type = type;
+        node.size = 0;
+        node.next = 0;
+        node.number = number;
+        node.key = key;
+        node.text = text;
+        return count++;
+    }
+
+    void takeFrom(Document &other)
+    {
+        arena = std::move(other.arena);
+        nodes = other.nodes;
+        count = other.count;
+        capacity = other.capacity;
+        openContainers = std::move(other.openContainers);
+        source = std::move(other.source);
+        other.nodes = nullptr;
+        other.count = 0;
+        other.capacity = 0;
+    }
+
+    // Moves the tape to a larger arena array; the old array is reclaimed with the arena.
+    void grow(size_t newCapacity)
+    {
+        if (newCapacity > UINT32_MAX)
+        {
+            throw std::length_error("Document exceeds the maximum number of nodes");
+        }
+        Node *larger = arena.allocateArray<Node>(newCapacity);
+        if (count > 0)
+        {
+            std::memcpy(static_cast<void *>(larger), nodes, count * sizeof(Node));
+        }
+        nodes = larger;
+        capacity = newCapacity;
+    }
+
+    void flatten(size_t index, const std::string &path, char separator, std::map<std::string, std::string> &pathMap) const
+    {
+        const Node &node = nodes[index];
+        if (node.type != Type::Array && node.type != Type::Object)
+        {
+            pathMap[path] = std::string(node.text);
+            return;
+        }
+        size_t position = 0;
+        for (size_t child = index + 1; child < node.next; child = nodes[child].next, ++position)
+        {
+            std::string segment = node.type == Type::Array ? std::to_string(position) : std::string(nodes[child].key);
+            flatten(child, path.empty() ? segment : path + separator + segment, separator, pathMap);
+        }
+    }
+};
+
+#endif // DOCUMENT_HPP
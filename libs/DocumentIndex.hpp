@@ -0,0 +1,455 @@
+#ifndef DOCUMENTINDEX_HPP
+#define DOCUMENTINDEX_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Document.hpp"
+
+/**
+ * @brief The DocumentIndex class answers path lookups and queries against a parsed Document.
+ *
+ * Building the index interns every member name once and records, for every node, its name and its
+ * occurrence among same-named siblings. Child lookups then go through a hash table keyed by
+ * (parent, name, occurrence), so resolving a path costs one hash probe per segment instead of a
+ * chain of string comparisons. The index refers to the document: the document must outlive it and
+ * must not be moved or modified while it is in use.
+ *
+ * Paths for find() use '/' between segments. A segment is a member name, optionally followed by a
+ * 1-based occurrence "[n]" for repeated names (as produced by XML), or a 0-based position when the
+ * parent is an array, e.g. "employees/employee[2]/@id" or "planets/0/name".
+ *
+ * query() accepts a subset of JSONPath and XPath:
+ * - JSONPath: "$", ".name", "['name']", ".*", "[*]", "[n]" (0-based array index), "..name", "..*".
+ * - XPath: "/name", "//name", "*", "name[n]" (1-based occurrence among same-named siblings).
+ */
+class DocumentIndex
+{
+public:
+    /**
+     * @brief Indexes the document in a single pass over its tape.
+     * @param document The document to index.
+     */
+    explicit DocumentIndex(const Document &document) : document(&document)
+    {
+        size_t count = document.nodeCount();
+        nodeSegments.resize(count, noSegment);
+        nodeOccurrences.resize(count, 0);
+        children.reserve(count);
+
+        std::vector<uint32_t> lastParent; // Per segment: the container that last counted it
+        std::vector<uint32_t> occurrences; // Per segment: occurrences seen in that container
+        for (size_t index = 0; index < count; ++index)
+        {
+            const Document::Node &node = document.nodeAt(index);
+            if (node.type != Document::Type::Array && node.type != Document::Type::Object)
+            {
+                continue;
+            }
+            uint32_t position = 0;
+            for (size_t child = index + 1; child < node.next; child = document.nodeAt(child).next, ++position)
+            {
+                uint32_t parent = static_cast<uint32_t>(index);
+                if (node.type == Document::Type::Array)
+                {
+                    children.emplace(ChildKey{parent, arraySegment, position}, static_cast<uint32_t>(child));
+                    continue;
+                }
+                uint32_t segment = intern(document.nodeAt(child).key);
+                if (segment >= lastParent.size())
+                {
+                    lastParent.resize(segment + 1, noSegment);
+                    occurrences.resize(segment + 1, 0);
+                }
+                if (lastParent[segment] != parent)
+                {
+                    lastParent[segment] = parent;
+                    occurrences[segment] = 0;
+                }
+                uint32_t occurrence = ++occurrences[segment];
+                nodeSegments[child] = segment;
+                nodeOccurrences[child] = occurrence;
+                children.emplace(ChildKey{parent, segment, occurrence}, static_cast<uint32_t>(child));
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of distinct member names in the document.
+     */
+    size_t segmentCount() const { return segments.size(); }
+
+    /**
+     * @brief Resolves a '/'-separated path from the root.
+     * @param path The path, e.g. "employees/employee[2]/id"; an empty path is the root.
+     * @return The value, or std::nullopt if any segment does not exist.
+     */
+    std::optional<Document::Value> find(std::string_view path) const
+    {
+        if (document->empty())
+        {
+            return std::nullopt;
+        }
+        uint32_t current = 0;
+        while (!path.empty())
+        {
+            size_t slash = path.find('/');
+            std::string_view segment = path.substr(0, slash);
+            path = slash == std::string_view::npos ? std::string_view() : path.substr(slash + 1);
+            std::optional<uint32_t> child = resolveSegment(current, segment);
+            if (!child)
+            {
+                return std::nullopt;
+            }
+            current = *child;
+        }
+        return Document::Value(document, current);
+    }
+
+    /**
+     * @brief Evaluates a JSONPath or XPath subset expression (see the class description).
+     * @param expression The expression, starting with '$' (JSONPath) or '/' (XPath).
+     * @return The matching values in document order, without duplicates.
+     * @throws std::runtime_error if the expression is malformed or unsupported.
+     */
+    std::vector<Document::Value> query(std::string_view expression) const
+    {
+        std::vector<Step> steps = compile(expression);
+        std::vector<uint32_t> context;
+        if (!document->empty())
+        {
+            context.push_back(0);
+        }
+        for (const Step &step : steps)
+        {
+            context = apply(step, context);
+        }
+        std::vector<Document::Value> values;
+        values.reserve(context.size());
+        for (uint32_t index : context)
+        {
+            values.emplace_back(document, index);
+        }
+        return values;
+    }
+
+private:
+    static constexpr uint32_t noSegment = UINT32_MAX;        // Name that does not occur in the document
+    static constexpr uint32_t arraySegment = UINT32_MAX - 1; // Pseudo-name for array positions
+
+    /**
+     * @brief Identifies a child by its parent, interned name and occurrence (or array position).
+     */
+    struct ChildKey
+    {
+        uint32_t parent;
+        uint32_t segment;
+        uint32_t occurrence;
+
+        bool operator==(const ChildKey &other) const
+        {
+            return parent == other.parent && segment == other.segment && occurrence == other.occurrence;
+        }
+    };
+
+    struct ChildKeyHash
+    {
+        size_t operator()(const ChildKey &key) const
+        {
+            uint64_t hash = (static_cast<uint64_t>(key.parent) << 32 | key.segment) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<size_t>((hash ^ (hash >> 29) ^ key.occurrence) * 0xBF58476D1CE4E5B9ULL);
+        }
+    };
+
+    /**
+     * @brief One compiled step of a query.
+     */
+    struct Step
+    {
+        enum class Test
+        {
+            Name,  // Members with the given name
+            Any,   // Every child
+            Index  // The array element at the given position
+        };
+        bool descendant = false;    // Match at any depth below the context instead of direct children
+        Test test = Test::Any;
+        uint32_t segment = noSegment;
+        uint32_t number = 0;        // Occurrence (1-based, 0 for all) for Name, position for Index
+    };
+
+    const Document *document;
+    std::unordered_map<std::string_view, uint32_t> segmentIds; // Interned member names
+    std::vector<std::string_view> segments;                    // Member names by id
+    std::vector<uint32_t> nodeSegments;                        // Name id of every node, noSegment if none
+    std::vector<uint32_t> nodeOccurrences;                     // 1-based occurrence among same-named siblings
+    std::unordered_map<ChildKey, uint32_t, ChildKeyHash> children;
+
+    uint32_t intern(std::string_view name)
+    {
+        auto inserted = segmentIds.emplace(name, static_cast<uint32_t>(segments.size()));
+        if (inserted.second)
+        {
+            segments.push_back(name);
+        }
+        return inserted.first->second;
+    }
+
+    uint32_t lookupSegment(std::string_view name) const
+    {
+        auto it = segmentIds.find(name);
+        return it == segmentIds.end() ? noSegment : it->second;
+    }
+
+    std::optional<uint32_t> findChild(uint32_t parent, uint32_t segment, uint32_t occurrence) const
+    {
+        auto it = children.find(ChildKey{parent, segment, occurrence});
+        if (it == children.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    static std::optional<uint32_t> parseNumber(std::string_view text)
+    {
+        uint32_t value = 0;
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size())
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    std::optional<uint32_t> resolveSegment(uint32_t parent, std::string_view segment) const
+    {
+        if (document->nodeAt(parent).type == Document::Type::Array)
+        {
+            std::optional<uint32_t> position = parseNumber(segment);
+            return position ? findChild(parent, arraySegment, *position) : std::nullopt;
+        }
+        uint32_t occurrence = 1;
+        if (!segment.empty() && segment.back() == ']')
+        {
+            size_t open = segment.rfind('[');
+            std::optional<uint32_t> number = open == std::string_view::npos ? std::nullopt : parseNumber(segment.substr(open + 1, segment.size() - open - 2));
+            if (number && *number > 0)
+            {
+                occurrence = *number;
+                segment = segment.substr(0, open);
+            }
+        }
+        uint32_t id = lookupSegment(segment);
+        return id == noSegment ? std::nullopt : findChild(parent, id, occurrence);
+    }
+
+    [[noreturn]] static void fail(std::string_view expression, const std::string &message)
+    {
+        throw std::runtime_error("Invalid path query '" + std::string(expression) + "': " + message);
+    }
+
+    static bool isNameChar(char c)
+    {
+        return c != '.' && c != '/' && c != '[' && c != ']' && c != '*';
+    }
+
+    std::vector<Step> compile(std::string_view expression) const
+    {
+        std::vector<Step> steps;
+        size_t i = 0;
+        if (!expression.empty() && expression[0] == '$')
+        {
+            i = 1;
+            while (i < expression.size())
+            {
+                Step step;
+                if (expression[i] == '.')
+                {
+                    ++i;
+                    if (i < expression.size() && expression[i] == '.')
+                    {
+                        step.descendant = true;
+                        ++i;
+                    }
+                    if (i < expression.size() && expression[i] == '*')
+                    {
+                        ++i;
+                    }
+                    else
+                    {
+                        size_t start = i;
+                        while (i < expression.size() && isNameChar(expression[i]))
+                            ++i;
+                        if (i == start)
+                            fail(expression, "expected a member name after '.'");
+                        step.test = Step::Test::Name;
+                        step.segment = lookupSegment(expression.substr(start, i - start));
+                    }
+                }
+                else if (expression[i] == '[')
+                {
+                    size_t close = expression.find(']', i);
+                    if (close == std::string_view::npos)
+                        fail(expression, "unterminated '['");
+                    std::string_view inside = expression.substr(i + 1, close - i - 1);
+                    i = close + 1;
+                    if (inside == "*")
+                    {
+                        step.test = Step::Test::Any;
+                    }
+                    else if (inside.size() >= 2 && (inside.front() == '\'' || inside.front() == '"') && inside.back() == inside.front())
+                    {
+                        step.test = Step::Test::Name;
+                        step.segment = lookupSegment(inside.substr(1, inside.size() - 2));
+                    }
+                    else if (std::optional<uint32_t> position = parseNumber(inside))
+                    {
+                        step.test = Step::Test::Index;
+                        step.number = *position;
+                    }
+                    else
+                    {
+                        fail(expression, "unsupported bracket expression [" + std::string(inside) + "]");
+                    }
+                }
+                else
+                {
+                    fail(expression, "unexpected character '" + std::string(1, expression[i]) + "'");
+                }
+                steps.push_back(step);
+            }
+            return steps;
+        }
+        if (expression.empty() || expression[0] != '/')
+        {
+            fail(expression, "expected '$' or '/' at the start");
+        }
+        while (i < expression.size())
+        {
+            Step step;
+            if (expression[i] != '/')
+                fail(expression, "expected '/'");
+            ++i;
+            if (i < expression.size() && expression[i] == '/')
+            {
+                step.descendant = true;
+                ++i;
+            }
+            if (i < expression.size() && expression[i] == '*')
+            {
+                ++i;
+            }
+            else
+            {
+                size_t start = i;
+                while (i < expression.size() && isNameChar(expression[i]))
+                    ++i;
+                if (i == start)
+                    fail(expression, "expected an element name after '/'");
+                step.test = Step::Test::Name;
+                step.segment = lookupSegment(expression.substr(start, i - start));
+            }
+            if (i < expression.size() && expression[i] == '[')
+            {
+                size_t close = expression.find(']', i);
+                std::optional<uint32_t> occurrence = close == std::string_view::npos ? std::nullopt : parseNumber(expression.substr(i + 1, close - i - 1));
+                if (!occurrence || *occurrence == 0 || step.test != Step::Test::Name)
+                    fail(expression, "expected a positive occurrence after a name");
+                step.number = *occurrence;
+                i = close + 1;
+            }
+            steps.push_back(step);
+        }
+        return steps;
+    }
+
+    bool matches(const Step &step, uint32_t parent, uint32_t node, uint32_t position) const
+    {
+        switch (step.test)
+        {
+        case Step::Test::Any:
+            return true;
+        case Step::Test::Index:
+            return document->nodeAt(parent).type == Document::Type::Array && position == step.number;
+        case Step::Test::Name:
+            return nodeSegments[node] == step.segment && (step.number == 0 || nodeOccurrences[node] == step.number);
+        }
+        return false;
+    }
+
+    // Calls visit(parent, child, position) for every direct child of a container.
+    template <typename Visitor>
+    void forEachChild(uint32_t parent, Visitor &&visit) const
+    {
+        const Document::Node &node = document->nodeAt(parent);
+        uint32_t position = 0;
+        for (uint32_t child = parent + 1; child < node.next; child = document->nodeAt(child).next, ++position)
+        {
+            visit(parent, child, position);
+        }
+    }
+
+    std::vector<uint32_t> apply(const Step &step, const std::vector<uint32_t> &context) const
+    {
+        std::vector<uint32_t> result;
+        if (step.test == Step::Test::Name && step.segment == noSegment)
+        {
+            return result; // The name never occurs in the document
+        }
+        for (uint32_t parent : context)
+        {
+            if (!step.descendant)
+            {
+                if (step.test == Step::Test::Name && step.number > 0)
+                {
+                    if (std::optional<uint32_t> child = findChild(parent, step.segment, step.number))
+                        result.push_back(*child);
+                }
+                else if (step.test == Step::Test::Index)
+                {
+                    if (document->nodeAt(parent).type == Document::Type::Array)
+                    {
+                        if (std::optional<uint32_t> child = findChild(parent, arraySegment, step.number))
+                            result.push_back(*child);
+                    }
+                }
+                else
+                {
+                    forEachChild(parent, [&](uint32_t container, uint32_t child, uint32_t position)
+                                 {
+                        if (matches(step, container, child, position))
+                            result.push_back(child); });
+                }
+                continue;
+            }
+            // Descendants: every container in the subtree contributes its matching children.
+            uint32_t end = document->nodeAt(parent).next;
+            for (uint32_t container = parent; container < end; ++container)
+            {
+                Document::Type type = document->nodeAt(container).type;
+                if (type == Document::Type::Array || type == Document::Type::Object)
+                {
+                    forEachChild(container, [&](uint32_t owner, uint32_t child, uint32_t position)
+                                 {
+                        if (matches(step, owner, child, position))
+                            result.push_back(child); });
+                }
+            }
+        }
+        if (context.size() > 1 || step.descendant)
+        {
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+        }
+        return result;
+    }
+};
+
+#endif // DOCUMENTINDEX_HPP
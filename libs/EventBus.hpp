@@ -0,0 +1,432 @@
+#ifndef EVENTBUS_HPP
+#define EVENTBUS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "Logger.hpp"
+#include "Delegate.hpp"
+
+/**
+ * @brief The EventBus class delivers events of any C++ type to the handlers subscribed to that type.
+ *
+ * Events are identified by their type rather than by a name: every type gets a small integer id
+ * the first time it is used, with no strings or RTTI involved, and subscribers are kept in an array
+ * indexed by that id. publish() is therefore an array access followed by one call per handler,
+ * with the event passed by reference. Handlers are stored in Delegates, so a handler capturing a
+ * few pointers or references is kept without a heap allocation.
+ *
+ * For high event rates, publishBatch() delivers a whole array of events at once: each handler is
+ * called for every event of the batch before the next handler runs, so the dispatch overhead is
+ * paid once per batch and each handler runs in a tight loop. Handlers subscribed with
+ * subscribeBatch() receive the array itself in a single call. Per-type counters of events,
+ * dispatches and dispatch time can be switched on with enableStats().
+ *
+ * Handlers are called in subscription order. They may subscribe and unsubscribe while an event is
+ * being published; new handlers are called from the next publish on. The bus is meant for one
+ * thread; synchronize externally to share it.
+ */
+class EventBus
+{
+public:
+    using SubscriptionId = uint64_t;
+
+    /**
+     * @brief Dispatch counters of one event type, collected while enableStats(true) is in effect.
+     */
+    struct Stats
+    {
+        uint64_t events = 0;                     // Events delivered
+        uint64_t dispatches = 0;                 // Calls to publish() and groups delivered by publishBatch()
+        std::chrono::nanoseconds totalTime{0};   // Time spent in the handlers of all dispatches
+        std::chrono::nanoseconds maxTime{0};     // Time spent in the handlers of the slowest dispatch
+
+        /**
+         * @brief Returns the mean time of one dispatch.
+         */
+        std::chrono::nanoseconds averageTime() const
+        {
+            return dispatches != 0 ? totalTime / static_cast<int64_t>(dispatches) : std::chrono::nanoseconds(0);
+        }
+
+        /**
+         * @brief Returns the events delivered per second of dispatch time.
+         */
+        double eventsPerSecond() const
+        {
+            return totalTime.count() != 0 ? events * 1e9 / static_cast<double>(totalTime.count()) : 0.0;
+        }
+    };
+
+    /**
+     * @brief Constructs an EventBus object.
+     */
+    EventBus()
+        : logger([]()
+                 {
+            std::string currentFile = __FILE__;
+            std::string::size_type pos = currentFile.find_last_of("/\\");
+            std::string fileName = currentFile.substr(pos + 1, currentFile.rfind(".") - pos - 1);
+            std::string logFilename = Logger::getLogsFilename(fileName);
+            return logFilename; }())
+    {
+        logger.log("EventBus instance created");
+    }
+
+    EventBus(const EventBus &) = delete;
+    EventBus &operator=(const EventBus &) = delete;
+
+    /**
+     * @brief Returns the id of an event type, the same in every bus of the process.
+     */
+    template <typename Event>
+    static size_t typeId()
+    {
+        if constexpr (!std::is_same_v<Event, std::decay_t<Event>>)
+        {
+            return typeId<std::decay_t<Event>>(); // const Event and Event are one type of event
+        }
+        else
+        {
+            static const size_t id = typeCounter().fetch_add(1, std::memory_order_relaxed);
+            return id;
+        }
+    }
+
+    /**
+     * @brief Subscribes a handler to events of type Event.
+     * @param handler Called as handler(const Event &) for each published event.
+     * @return The id to pass to unsubscribe.
+     */
+    template <typename Event, typename Handler>
+    SubscriptionId subscribe(Handler &&handler)
+    {
+        return add(typeId<Event>(), [handler = std::forward<Handler>(handler)](const void *events, size_t count) mutable
+                   {
+                       const std::decay_t<Event> *event = static_cast<const std::decay_t<Event> *>(events);
+                       for (size_t i = 0; i < count; ++i)
+                       {
+                           handler(event[i]);
+                       }
+                   });
+    }
+
+    /**
+     * @brief Subscribes a handler that receives events of type Event a batch at a time.
+     * @param handler Called as handler(const Event *events, size_t count), once per publish() with
+     * one event and once per group delivered by publishBatch(); count is never 0.
+     * @return The id to pass to unsubscribe.
+     */
+    template <typename Event, typename Handler>
+    SubscriptionId subscribeBatch(Handler &&handler)
+    {
+        return add(typeId<Event>(), [handler = std::forward<Handler>(handler)](const void *events, size_t count) mutable
+                   { handler(static_cast<const std::decay_t<Event> *>(events), count); });
+    }
+
+    /**
+     * @brief Removes a subscription. The handler is not called by publishes that start afterwards.
+     * @return false if there is no such subscription.
+     */
+    bool unsubscribe(SubscriptionId subscription)
+    {
+        auto found = subscriptions.find(subscription);
+        if (found == subscriptions.end())
+        {
+            return false;
+        }
+        size_t type = found->second;
+        subscriptions.erase(found);
+        for (Subscriber &subscriber : channels[type]->subscribers)
+        {
+            if (subscriber.id == subscription)
+            {
+                subscriber.active = false;
+                break;
+            }
+        }
+        for (auto &[pendingType, subscriber] : subscribedDuringPublish)
+        {
+            if (subscriber.id == subscription)
+            {
+                subscriber.active = false;
+                break;
+            }
+        }
+        if (publishDepth == 0)
+        {
+            compact(type);
+        }
+        else
+        {
+            unsubscribedDuringPublish.push_back(type);
+        }
+        logger.log("Unsubscribed from event type " + std::to_string(type));
+        return true;
+    }
+
+    /**
+     * @brief Calls every handler subscribed to the type of the event.
+     * Publishing a type nobody subscribed to does nothing.
+     * @param event The event, passed to the handlers by reference.
+     * @throws Exceptions from a handler propagate and skip the remaining handlers.
+     */
+    template <typename Event>
+    void publish(const Event &event)
+    {
+        dispatch(typeId<Event>(), &event, 1);
+    }
+
+    /**
+     * @brief Delivers an array of events of one type. Each handler is called for every event, in
+     * order, before the next handler runs; batch handlers are called once with the whole array.
+     * @param events The first event.
+     * @param count The number of events; publishing none does nothing.
+     * @throws Exceptions from a handler propagate and skip the remaining events and handlers.
+     */
+    template <typename Event>
+    void publishBatch(const Event *events, size_t count)
+    {
+        if (count != 0)
+        {
+            dispatch(typeId<Event>(), events, count);
+        }
+    }
+
+    /**
+     * @brief Delivers a vector of events of one type (see publishBatch(const Event *, size_t)).
+     */
+    template <typename Event>
+    void publishBatch(const std::vector<Event> &events)
+    {
+        publishBatch(events.data(), events.size());
+    }
+
+    /**
+     * @brief Delivers events of several types, grouped by type: the events of each alternative
+     * are delivered as one batch, in the order of the alternatives, keeping their relative order.
+     * Groups nobody subscribed to are skipped without copying their events.
+     * @param events The first event.
+     * @param count The number of events.
+     */
+    template <typename... Events>
+    void publishBatch(const std::variant<Events...> *events, size_t count)
+    {
+        (publishGroup<Events>(events, count), ...);
+    }
+
+    /**
+     * @brief Delivers a vector of events of several types, grouped by type.
+     */
+    template <typename... Events>
+    void publishBatch(const std::vector<std::variant<Events...>> &events)
+    {
+        publishBatch(events.data(), events.size());
+    }
+
+    /**
+     * @brief Returns the number of handlers subscribed to events of type Event.
+     */
+    template <typename Event>
+    size_t subscriberCount() const
+    {
+        size_t type = typeId<Event>();
+        if (type >= channels.size() || !channels[type])
+        {
+            return 0;
+        }
+        const std::vector<Subscriber> &subscribers = channels[type]->subscribers;
+        size_t count = static_cast<size_t>(std::count_if(subscribers.begin(), subscribers.end(), [](const Subscriber &subscriber)
+                                                         { return subscriber.active; }));
+        for (const auto &[pendingType, subscriber] : subscribedDuringPublish)
+        {
+            count += pendingType == type && subscriber.active ? 1 : 0;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Starts or stops collecting dispatch counters. Timing each dispatch costs two clock
+     * reads, so it is off by default; counters collected so far are kept.
+     */
+    void enableStats(bool enabled)
+    {
+        statsEnabled = enabled;
+    }
+
+    /**
+     * @brief Returns the dispatch counters of events of type Event.
+     */
+    template <typename Event>
+    Stats stats() const
+    {
+        size_t type = typeId<Event>();
+        return type < channels.size() && channels[type] ? channels[type]->stats : Stats();
+    }
+
+    /**
+     * @brief Clears the dispatch counters of every event type.
+     */
+    void resetStats()
+    {
+        for (std::unique_ptr<Channel> &channel : channels)
+        {
+            if (channel)
+            {
+                channel->stats = Stats();
+            }
+        }
+    }
+
+private:
+    struct Subscriber
+    {
+        SubscriptionId id;
+        Delegate<void(const void *, size_t)> handler; // Receives a pointer to the first event and the event count
+        bool active; // Cleared by unsubscribe; the entry is removed once no publish is running
+    };
+
+    // The handlers of one event type. The list is not changed while a publish is running, so
+    // publish() can walk it directly.
+    struct Channel
+    {
+        std::vector<Subscriber> subscribers;
+        Stats stats;
+    };
+
+    // Counts nested publishes and applies the subscription changes made during them when the
+    // outermost one ends
+    struct PublishGuard
+    {
+        EventBus &bus;
+        explicit PublishGuard(EventBus &bus) : bus(bus) { ++bus.publishDepth; }
+        ~PublishGuard()
+        {
+            if (--bus.publishDepth == 0 && (!bus.subscribedDuringPublish.empty() || !bus.unsubscribedDuringPublish.empty()))
+            {
+                for (auto &[type, subscriber] : bus.subscribedDuringPublish)
+                {
+                    bus.channels[type]->subscribers.push_back(std::move(subscriber));
+                }
+                bus.subscribedDuringPublish.clear();
+                for (size_t type : bus.unsubscribedDuringPublish)
+                {
+                    bus.compact(type);
+                }
+                bus.unsubscribedDuringPublish.clear();
+            }
+        }
+    };
+
+    Logger logger; // Logger instance for logging events
+    std::vector<std::unique_ptr<Channel>> channels; // Indexed by typeId; Channels stay in place when this grows
+    std::unordered_map<SubscriptionId, size_t> subscriptions; // The event type of each subscription
+    SubscriptionId nextSubscription = 1;
+    bool statsEnabled = false;
+    size_t publishDepth = 0; // Number of publishes in progress
+    std::vector<std::pair<size_t, Subscriber>> subscribedDuringPublish; // New handlers by type, added when publishing ends
+    std::vector<size_t> unsubscribedDuringPublish; // Types with inactive handlers to remove
+
+    static std::atomic<size_t> &typeCounter()
+    {
+        static std::atomic<size_t> counter{0};
+        return counter;
+    }
+
+    SubscriptionId add(size_t type, Delegate<void(const void *, size_t)> handler)
+    {
+        if (type >= channels.size())
+        {
+            channels.resize(type + 1);
+        }
+        if (!channels[type])
+        {
+            channels[type] = std::make_unique<Channel>();
+        }
+        SubscriptionId subscription = nextSubscription++;
+        Subscriber subscriber{subscription, std::move(handler), true};
+        if (publishDepth == 0)
+        {
+            channels[type]->subscribers.push_back(std::move(subscriber));
+        }
+        else
+        {
+            subscribedDuringPublish.emplace_back(type, std::move(subscriber));
+        }
+        subscriptions.emplace(subscription, type);
+        logger.log("Subscribed to event type " + std::to_string(type));
+        return subscription;
+    }
+
+    void dispatch(size_t type, const void *events, size_t count)
+    {
+        if (type >= channels.size() || !channels[type])
+        {
+            return;
+        }
+        Channel &channel = *channels[type];
+        PublishGuard guard(*this);
+        if (!statsEnabled)
+        {
+            for (const Subscriber &subscriber : channel.subscribers)
+            {
+                if (subscriber.active)
+                {
+                    subscriber.handler(events, count);
+                }
+            }
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (const Subscriber &subscriber : channel.subscribers)
+        {
+            if (subscriber.active)
+            {
+                subscriber.handler(events, count);
+            }
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        channel.stats.events += count;
+        ++channel.stats.dispatches;
+        channel.stats.totalTime += elapsed;
+        channel.stats.maxTime = std::max(channel.stats.maxTime, elapsed);
+    }
+
+    // Delivers the events of one alternative of a variant array as a batch
+    template <typename Event, typename... Events>
+    void publishGroup(const std::variant<Events...> *events, size_t count)
+    {
+        size_t type = typeId<Event>();
+        if (type >= channels.size() || !channels[type] || channels[type]->subscribers.empty())
+        {
+            return;
+        }
+        std::vector<Event> group;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (const Event *event = std::get_if<Event>(&events[i]))
+            {
+                group.push_back(*event);
+            }
+        }
+        publishBatch(group.data(), group.size());
+    }
+
+    void compact(size_t type)
+    {
+        std::vector<Subscriber> &subscribers = channels[type]->subscribers;
+        subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(), [](const Subscriber &subscriber)
+                                         { return !subscriber.active; }),
+                          subscribers.end());
+    }
+};
+
+#endif // EVENTBUS_HPP
@@ -4,17 +4,91 @@
 #define EVENTHANDLINGSYSTEM_HPP
 
 #include "Logger.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
 #include <functional>
-#include <map>
+#include <mutex>
 #include <string>
 #include <stdexcept>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
 
 /**
  * @brief The EventHandlingSystem class handles event registration and triggering.
+ *
+ * Any number of callbacks can subscribe to an event; triggering calls them in subscription order.
+ * Event names are interned to dense integer ids the first time they are seen, so triggering by name
+ * costs one hash lookup and triggering through an EventHandle none at all.
+ *
+ * An event either carries no data or a payload of one type, fixed when it is first registered;
+ * the payload is passed to the callbacks by reference without copying. Callbacks may subscribe
+ * and unsubscribe while an event is being triggered; new subscribers are called from the next
+ * trigger on.
+ *
+ * All methods may be called from several threads. Each call holds the system's lock, triggers
+ * included, so callbacks of different triggers never run at the same time; a callback may use the
+ * system itself, but must not wait for another thread that does.
  */
 class EventHandlingSystem {
+public:
+    using EventId = uint32_t;
+    using SubscriptionId = uint64_t;
+
+private:
+    // The callback type for a payload type (partially specialized, as full specializations cannot be members)
+    template <typename Payload, typename = void>
+    struct CallbackOf {
+        using type = std::function<void(const Payload&)>;
+    };
+    template <typename Unused>
+    struct CallbackOf<void, Unused> {
+        using type = std::function<void()>;
+    };
+
+public:
+
+    /**
+     * @brief A typed reference to an interned event, obtained from handle().
+     * Subscribing and triggering through it skips the name lookup and the payload type check.
+     */
+    template <typename Payload = void>
+    class EventHandle {
+    public:
+        using Callback = typename CallbackOf<Payload>::type;
+
+        EventId id() const { return eventId; }
+
+    private:
+        friend class EventHandlingSystem;
+        explicit EventHandle(EventId id) : eventId(id) {}
+        EventId eventId;
+    };
+
+private:
+    struct Subscriber {
+        SubscriptionId id;
+        std::function<void(const void *)> callback; // Receives a pointer to the payload, or nullptr
+        bool active; // Cleared by unsubscribe; the entry is removed once no trigger is running
+    };
+
+    // One interned event
+    struct Event {
+        std::string name;
+        std::type_index payloadType = typeid(void); // void for events without a payload
+        std::deque<Subscriber> subscribers; // A deque so callbacks stay in place while others subscribe
+    };
+
     Logger logger; // Logger instance for logging events
-    std::map<std::string, std::function<void()>> eventMap; // Map to store event names and their corresponding callback functions
+    mutable std::recursive_mutex mutex; // Guards everything below; recursive so callbacks can use the system
+    std::unordered_map<std::string, EventId> eventIds; // Interned event names
+    std::deque<Event> events; // Indexed by EventId; a deque so events stay in place while others are registered
+    std::unordered_map<SubscriptionId, EventId> subscriptions; // The event of each subscription
+    SubscriptionId nextSubscription = 1;
+    size_t dispatchDepth = 0; // Number of triggers in progress
+    std::vector<EventId> unsubscribedDuringDispatch; // Events with inactive subscribers to remove
 
 public:
     /**
@@ -34,27 +108,205 @@ public:
     }
 
     /**
-     * @brief Registers an event with a callback function.
+     * @brief Returns a handle to an event, registering the event if it is new.
+     * @param eventName The name of the event.
+     * @return The handle, valid for the lifetime of this object.
+     * @throws std::runtime_error if the event is registered with another payload type.
+     */
+    template <typename Payload = void>
+    EventHandle<Payload> handle(const std::string& eventName) {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        return EventHandle<Payload>(intern(eventName, typeid(Payload)));
+    }
+
+    /**
+     * @brief Subscribes a callback function to an event, registering the event if it is new.
      * @param eventName The name of the event to be registered.
      * @param callback The callback function to be called when the event is triggered.
+     * @return The id to pass to unsubscribe.
+     * @throws std::runtime_error if the event is registered with a payload.
      */
-    void registerEvent(const std::string& eventName, std::function<void()> callback) {
-        eventMap[eventName] = callback;
-        logger.log("Event registered: " + eventName);
+    SubscriptionId registerEvent(const std::string& eventName, std::function<void()> callback) {
+        return subscribe(handle(eventName), std::move(callback));
+    }
+
+    /**
+     * @brief Subscribes a callback function to an event that carries a payload of type Payload.
+     * @param eventName The name of the event to be registered.
+     * @param callback The callback function receiving the payload of each trigger.
+     * @return The id to pass to unsubscribe.
+     * @throws std::runtime_error if the event is registered with another payload type.
+     */
+    template <typename Payload>
+    SubscriptionId registerEvent(const std::string& eventName, std::function<void(const Payload&)> callback) {
+        return subscribe(handle<Payload>(eventName), std::move(callback));
+    }
+
+    /**
+     * @brief Subscribes a callback function to an event without a payload.
+     */
+    SubscriptionId subscribe(EventHandle<void> event, std::function<void()> callback) {
+        return add(event.eventId, [callback = std::move(callback)](const void *) { callback(); });
+    }
+
+    /**
+     * @brief Subscribes a callback function to an event with a payload.
+     */
+    template <typename Payload>
+    SubscriptionId subscribe(EventHandle<Payload> event, typename EventHandle<Payload>::Callback callback) {
+        return add(event.eventId, [callback = std::move(callback)](const void *payload) {
+            callback(*static_cast<const Payload *>(payload));
+        });
+    }
+
+    /**
+     * @brief Removes a subscription. The callback is not called by triggers that start afterwards.
+     * @return false if there is no such subscription.
+     */
+    bool unsubscribe(SubscriptionId subscription) {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        auto found = subscriptions.find(subscription);
+        if (found == subscriptions.end()) {
+            return false;
+        }
+        Event& event = events[found->second];
+        for (Subscriber& subscriber : event.subscribers) {
+            if (subscriber.id == subscription) {
+                subscriber.active = false;
+                break;
+            }
+        }
+        if (dispatchDepth == 0) {
+            compact(event);
+        } else {
+            unsubscribedDuringDispatch.push_back(found->second);
+        }
+        subscriptions.erase(found);
+        logger.log("Event unsubscribed: " + event.name);
+        return true;
     }
 
     /**
-     * @brief Triggers an event by calling its callback function.
+     * @brief Returns the number of callbacks subscribed to an event (0 if it is not registered).
+     */
+    size_t subscriberCount(const std::string& eventName) const {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        auto found = eventIds.find(eventName);
+        if (found == eventIds.end()) {
+            return 0;
+        }
+        size_t count = 0;
+        for (const Subscriber& subscriber : events[found->second].subscribers) {
+            count += subscriber.active ? 1 : 0;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Triggers an event by calling its callback functions.
      * @param eventName The name of the event to be triggered.
-     * @throws std::runtime_error if the event is not registered.
+     * @throws std::runtime_error if the event is not registered or expects a payload; exceptions
+     * from a callback propagate and skip the remaining callbacks.
      */
     void triggerEvent(const std::string& eventName) {
-        if (eventMap.find(eventName) == eventMap.end()) {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        dispatch(find(eventName, typeid(void)), nullptr); // Call the callback functions
+        logger.log("Event triggered: " + eventName);
+    }
+
+    /**
+     * @brief Triggers an event with a payload.
+     * @param eventName The name of the event to be triggered.
+     * @param payload The data passed to the callbacks.
+     * @throws std::runtime_error if the event is not registered or expects another payload type.
+     */
+    template <typename Payload>
+    void triggerEvent(const std::string& eventName, const Payload& payload) {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        dispatch(find(eventName, typeid(Payload)), &payload);
+        logger.log("Event triggered: " + eventName);
+    }
+
+    /**
+     * @brief Triggers an event through its handle, without a lookup or a log entry.
+     */
+    void triggerEvent(EventHandle<void> event) {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        dispatch(event.eventId, nullptr);
+    }
+
+    /**
+     * @brief Triggers an event with a payload through its handle, without a lookup or a log entry.
+     */
+    template <typename Payload>
+    void triggerEvent(EventHandle<Payload> event, const Payload& payload) {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        dispatch(event.eventId, &payload);
+    }
+
+private:
+    EventId intern(const std::string& eventName, std::type_index payloadType) {
+        auto found = eventIds.find(eventName);
+        if (found != eventIds.end()) {
+            if (events[found->second].payloadType != payloadType) {
+                logger.log("Event payload mismatch: " + eventName);
+                throw std::runtime_error("Event payload type mismatch");
+            }
+            return found->second;
+        }
+        EventId id = static_cast<EventId>(events.size());
+        events.push_back(Event{eventName, payloadType, {}});
+        eventIds.emplace(eventName, id);
+        logger.log("Event registered: " + eventName);
+        return id;
+    }
+
+    EventId find(const std::string& eventName, std::type_index payloadType) {
+        auto found = eventIds.find(eventName);
+        if (found == eventIds.end()) {
             logger.log("Event not found: " + eventName);
             throw std::runtime_error("Event not registered");
         }
-        eventMap[eventName](); // Call the callback function
-        logger.log("Event triggered: " + eventName);
+        if (events[found->second].payloadType != payloadType) {
+            logger.log("Event payload mismatch: " + eventName);
+            throw std::runtime_error("Event payload type mismatch");
+        }
+        return found->second;
+    }
+
+    SubscriptionId add(EventId id, std::function<void(const void *)> callback) {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        SubscriptionId subscription = nextSubscription++;
+        events[id].subscribers.push_back(Subscriber{subscription, std::move(callback), true});
+        subscriptions.emplace(subscription, id);
+        return subscription;
+    }
+
+    void dispatch(EventId id, const void *payload) {
+        struct DepthGuard {
+            EventHandlingSystem& system;
+            explicit DepthGuard(EventHandlingSystem& system) : system(system) { ++system.dispatchDepth; }
+            ~DepthGuard() {
+                if (--system.dispatchDepth == 0) {
+                    for (EventId id : system.unsubscribedDuringDispatch) {
+                        system.compact(system.events[id]);
+                    }
+                    system.unsubscribedDuringDispatch.clear();
+                }
+            }
+        } guard(*this);
+        // Index-based, since subscribers may be added while callbacks run
+        for (size_t i = 0, count = events[id].subscribers.size(); i < count; ++i) {
+            const Subscriber& subscriber = events[id].subscribers[i];
+            if (subscriber.active) {
+                subscriber.callback(payload);
+            }
+        }
+    }
+
+    void compact(Event& event) {
+        auto end = std::remove_if(event.subscribers.begin(), event.subscribers.end(), [](const Subscriber& subscriber) { return !subscriber.active; });
+        event.subscribers.erase(end, event.subscribers.end());
     }
 };
 
@@ -2,6 +2,7 @@
 #define FILEMANAGER_HPP
 
 #include "Logger.hpp"
+#include "MappedFile.hpp"
 #include <fstream>
 #include <filesystem>
 #include <string>
@@ -66,11 +67,44 @@ public:
             logger.log(errMsg);
             throw std::runtime_error(errMsg);
         }
-        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        // Read in large blocks rather than by character; sizes from stat() are not trusted, since
+        // files such as those under /proc report 0 and a file may shrink while it is being read
+        std::string content;
+        char buffer[1 << 16];
+        while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+            content.append(buffer, static_cast<size_t>(file.gcount()));
+        }
+        if (file.bad()) {
+            std::string errMsg = "Failed to read file: " + path;
+            logger.log(errMsg);
+            throw std::runtime_error(errMsg);
+        }
         logger.log("File read: " + path);
         return content;
     }
 
+    /**
+     * @brief Maps the file at the specified path into memory without copying it.
+     * 
+     * @param path The path of the file to map.
+     * @return The mapped file; its view() stays valid while the MappedFile is alive.
+     * @throws std::runtime_error if the file does not exist or fails to map.
+     */
+    MappedFile mapFile(const std::string& path) {
+        if (!std::filesystem::exists(path)) {
+            throw std::runtime_error("File does not exist: " + path);
+        }
+        try {
+            MappedFile mappedFile(path);
+            logger.log("File mapped: " + path);
+            return mappedFile;
+        } catch (const std::runtime_error&) {
+            std::string errMsg = "Failed to open file for reading: " + path;
+            logger.log(errMsg);
+            throw std::runtime_error(errMsg);
+        }
+    }
+
     /**
      * @brief Updates the content of the file at the specified path.
      * 
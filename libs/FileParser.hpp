@@ -3,13 +3,33 @@
 
 #include <iostream>
 #include <fstream>
-#include <regex>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <random>
 #include "Logger.hpp"
 #include "FileManager.hpp"
+#include "MappedFile.hpp"
+#include "Document.hpp"
+#include "DocumentIndex.hpp"
+#include "JsonParser.hpp"
+#include "JsonOnDemand.hpp"
+#include "CsvParser.hpp"
+#include "ColumnarFile.hpp"
+#include "XmlParser.hpp"
+#include "ThreadPool.hpp"
+#include "StreamingParser.hpp"
+#include "OutputBuffer.hpp"
+#include "ParseCache.hpp"
+#include "Serializer.hpp"
 
 /**
  * @brief The FileParser class is responsible for parsing different types of files such as JSON, CSV, and XML.
@@ -18,6 +38,30 @@ class FileParser
 {
     Logger logger; // Logger instance for logging events
 public:
+    /**
+     * @brief The data formats FileParser can detect and parse.
+     */
+    enum class Format
+    {
+        Unknown,
+        JSON,
+        CSV,
+        XML
+    };
+
+    static constexpr size_t defaultCacheBudget = 64 * 1024 * 1024; // Default memory budget of enableCache
+
+    /**
+     * @brief The outcome of parsing one file of a batch.
+     */
+    struct ParsedFile
+    {
+        std::string path;                       // The file that was parsed
+        Format format = Format::Unknown;        // The detected format
+        std::map<std::string, std::string> data; // Flattened paths, as returned by parse()
+        std::string error;                      // Empty on success, otherwise the failure reason
+    };
+
     /**
      * @brief Constructs a FileParser object.
      * It initializes the logger instance with a log filename based on the current file name.
@@ -35,60 +79,499 @@ public:
     }
 
     /**
-     * @brief Parses a JSON file and returns the parsed data as a string.
+     * @brief Parses a JSON file and returns the values flattened into "parent/child" paths.
+     * Array elements use their index as the path segment (e.g. "planets/0/name").
      * @param filepath The path to the JSON file.
-     * @return The parsed JSON data as a string.
+     * @return The flattened path to value map.
      */
     std::map<std::string, std::string> parseJSON(const std::string &filepath)
     {
         std::map<std::string, std::string> jsonMap;
         try
         {
-            std::string jsonData = readFile(filepath);
-            std::regex jsonRegex("\"([^\"]+)\":\\s*([^,\\n\\r]+)");
-            std::smatch jsonMatch;
+            jsonMap = fileCache ? loadParsed(filepath, Format::JSON)->data
+                                : JsonParser::parseInPlace(readFile(filepath).view()).toPathMap();
+            logger.log("JSON file parsed successfully.");
+            recordParsed(Format::JSON, jsonMap);
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error parsing JSON: " + std::string(e.what()));
+        }
+        return jsonMap;
+    }
+
+    /**
+     * @brief Parses JSON held in memory, e.g. an HTTP response body, like parseJSON does for files.
+     * @param data The JSON text.
+     * @return The flattened path to value map.
+     */
+    std::map<std::string, std::string> parseJSONBuffer(std::string_view data)
+    {
+        std::map<std::string, std::string> jsonMap;
+        try
+        {
+            jsonMap = JsonParser::parseInPlace(data).toPathMap();
+            logger.log("JSON buffer parsed successfully.");
+            recordParsed(Format::JSON, jsonMap);
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error parsing JSON: " + std::string(e.what()));
+        }
+        return jsonMap;
+    }
 
-            while (std::regex_search(jsonData, jsonMatch, jsonRegex))
+    /**
+     * @brief Parses a file of any supported format, detected from its content (see detectFormat).
+     * CSV files are parsed with the detected delimiter.
+     * @param filepath The path to the file.
+     * @return The flattened path to value map, as returned by parseJSON, parseCSV or parseXML.
+     */
+    std::map<std::string, std::string> parse(const std::string &filepath)
+    {
+        std::map<std::string, std::string> dataMap;
+        try
+        {
+            Format format;
+            if (fileCache)
             {
-                jsonMap[jsonMatch[1]] = jsonMatch[2];
-                jsonData = jsonMatch.suffix();
+                std::shared_ptr<const ParsedFile> parsed = loadParsed(filepath, Format::Unknown);
+                format = parsed->format;
+                dataMap = parsed->data;
             }
+            else
+            {
+                MappedFile file = readFile(filepath);
+                format = detectFormat(file.view());
+                dataMap = parseData(format, file.view());
+            }
+            logger.log(formatName(format) + " file parsed successfully.");
+            recordParsed(format, dataMap);
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error parsing " + filepath + ": " + std::string(e.what()));
+        }
+        return dataMap;
+    }
 
-            logger.log("JSON file parsed successfully.");
+    /**
+     * @brief Parses data of any supported format held in memory, detected from its content.
+     * @param data The file contents.
+     * @return The flattened path to value map.
+     */
+    std::map<std::string, std::string> parseBuffer(std::string_view data)
+    {
+        std::map<std::string, std::string> dataMap;
+        try
+        {
+            Format format = detectFormat(data);
+            dataMap = parseData(format, data);
+            logger.log(formatName(format) + " buffer parsed successfully.");
+            recordParsed(format, dataMap);
         }
         catch (const std::exception &e)
         {
-            logger.log("Error parsing JSON: " + std::string(e.what()));
+            logger.log("Error parsing buffer: " + std::string(e.what()));
         }
-        return jsonMap;
+        return dataMap;
     }
 
     /**
-     * @brief Parses a CSV file and returns the parsed data as a string.
-     * @param filepath The path to the CSV file.
-     * @return The parsed CSV data as a string.
+     * @brief Turns on caching of parse results (see ParseCache), or changes its memory budget.
+     * While enabled, parseJSON, parseXML, parse, parseCached and parseDocumentCached do not parse
+     * a file again until its content changes.
+     * @param memoryBudget The estimated memory allowed for cached path maps, and separately for
+     * cached documents, in bytes.
      */
-    std::map<std::string, std::string> parseCSV(const std::string &filepath)
+    void enableCache(size_t memoryBudget = defaultCacheBudget)
+    {
+        if (fileCache)
+        {
+            fileCache->setBudget(memoryBudget);
+            documentCache->setBudget(memoryBudget);
+            return;
+        }
+        fileCache = std::make_unique<ParseCache<ParsedFile>>(memoryBudget, [](const ParsedFile &parsed, const MappedFile &)
+                                                             {
+            size_t bytes = sizeof(ParsedFile) + parsed.path.capacity();
+            for (const auto &[path, value] : parsed.data)
+            {
+                bytes += mapNodeOverhead + path.capacity() + value.capacity();
+            }
+            return bytes; });
+        documentCache = std::make_unique<ParseCache<Document>>(memoryBudget, [](const Document &document, const MappedFile &file)
+                                                               { return sizeof(Document) + document.memoryArena().bytesReserved() + file.size(); });
+        logger.log("Parse cache enabled.");
+    }
+
+    /**
+     * @brief Turns off the parse cache and frees its entries. Results already returned stay valid.
+     */
+    void disableCache()
+    {
+        fileCache.reset();
+        documentCache.reset();
+        logger.log("Parse cache disabled.");
+    }
+
+    /**
+     * @brief Parses a file into a shared, immutable ParsedFile, served from the cache when the
+     * file is unchanged (the cache must be enabled for results to be kept).
+     * @param filepath The path to the file.
+     * @param format The format to parse as, or Unknown to detect it from the content.
+     * @return The parse result; its error field is always empty.
+     * @throws std::runtime_error if the file cannot be read or parsed.
+     */
+    std::shared_ptr<const ParsedFile> parseCached(const std::string &filepath, Format format = Format::Unknown)
     {
-        std::map<std::string, std::string> csvMap;
         try
         {
-            std::string csvData = readFile(filepath);
-            std::istringstream csvStream(csvData);
-            std::string line;
+            std::shared_ptr<const ParsedFile> parsed = loadParsed(filepath, format);
+            logger.log(formatName(parsed->format) + " file parsed (cached) successfully.");
+            return parsed;
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error parsing " + filepath + ": " + std::string(e.what()));
+            throw;
+        }
+    }
 
-            while (std::getline(csvStream, line))
+    /**
+     * @brief Parses a JSON or XML file (detected from its content) into a shared, immutable
+     * Document, served from the cache when the file is unchanged.
+     * @param filepath The path to the file.
+     * @return The document; it keeps its own copy of the file, so later changes to the file do not
+     * affect it.
+     * @throws std::runtime_error if the file cannot be read, is neither JSON nor XML, or is malformed.
+     */
+    std::shared_ptr<const Document> parseDocumentCached(const std::string &filepath)
+    {
+        try
+        {
+            ParseCache<Document>::Loader load = [](const std::shared_ptr<const MappedFile> &file)
             {
-                std::istringstream lineStream(line);
-                std::string key, value;
+                Format format = detectFormat(file->view());
+                std::string_view text = skipByteOrderMark(file->view());
+                if (format != Format::JSON && format != Format::XML)
+                {
+                    throw std::runtime_error("Not a JSON or XML document");
+                }
+                Document document = format == Format::JSON ? JsonParser::parseInPlace(text) : XmlPullParser::parseDocumentInPlace(text);
+                document.retainSource(file);
+                return document;
+            };
+            std::shared_ptr<const Document> document = documentCache ? documentCache->get(filepath, "Document", load)
+                                                                     : std::make_shared<const Document>(load(std::make_shared<const MappedFile>(MappedFile::copyOf(filepath))));
+            logger.log("Document parsed (cached) successfully.");
+            return document;
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error parsing document " + filepath + ": " + std::string(e.what()));
+            throw;
+        }
+    }
+
+    /**
+     * @brief Parses every regular file of a directory in parallel on the worker pool.
+     *
+     * Results are handed to the callback on the calling thread in the order the files finish, so
+     * the callback needs no synchronization. Files that fail to parse are reported with an error
+     * instead of stopping the batch. If the callback throws, the remaining files are still
+     * awaited before the exception propagates.
+     * @param directory The directory to scan.
+     * @param onResult Called once per file as soon as it has been parsed.
+     * @param recursive Whether subdirectories are scanned as well.
+     * @return The number of files parsed.
+     * @throws std::filesystem::filesystem_error if the directory cannot be listed.
+     */
+    size_t parseDirectory(const std::string &directory, const std::function<void(const ParsedFile &)> &onResult, bool recursive = false)
+    {
+        std::vector<std::string> paths;
+        if (recursive)
+        {
+            for (const auto &entry : std::filesystem::recursive_directory_iterator(directory))
+            {
+                if (entry.is_regular_file())
+                    paths.push_back(entry.path().string());
+            }
+        }
+        else
+        {
+            for (const auto &entry : std::filesystem::directory_iterator(directory))
+            {
+                if (entry.is_regular_file())
+                    paths.push_back(entry.path().string());
+            }
+        }
 
-                if (std::getline(lineStream, key, ',') && std::getline(lineStream, value))
+        // Shared with the tasks, so a worker still inside notify after the last result was taken
+        // never touches state the caller has already destroyed
+        struct Completion
+        {
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::deque<ParsedFile> files;
+        };
+        auto completion = std::make_shared<Completion>();
+        auto next = [&completion]()
+        {
+            std::unique_lock<std::mutex> lock(completion->mutex);
+            completion->condition.wait(lock, [&]()
+                                       { return !completion->files.empty(); });
+            ParsedFile result = std::move(completion->files.front());
+            completion->files.pop_front();
+            return result;
+        };
+        size_t submitted = 0;
+        try
+        {
+            for (const std::string &path : paths)
+            {
+                workerPool().submit([this, completion, path]()
+                                    {
+                    ParsedFile result = parseFileQuietly(path);
+                    std::lock_guard<std::mutex> lock(completion->mutex);
+                    completion->files.push_back(std::move(result));
+                    completion->condition.notify_one(); });
+                ++submitted;
+            }
+        }
+        catch (...)
+        {
+            // The tasks already queued still use this parser
+            for (size_t received = 0; received < submitted; ++received)
+            {
+                next();
+            }
+            throw;
+        }
+
+        std::exception_ptr callbackError;
+        for (size_t received = 0; received < paths.size(); ++received)
+        {
+            ParsedFile result = next();
+            logger.log(result.error.empty() ? formatName(result.format) + " file parsed successfully: " + result.path
+                                            : "Error parsing " + result.path + ": " + result.error);
+            if (!callbackError)
+            {
+                try
                 {
-                    csvMap[key] = value;
+                    onResult(result);
+                }
+                catch (...)
+                {
+                    callbackError = std::current_exception();
                 }
             }
+        }
+        if (callbackError)
+        {
+            std::rethrow_exception(callbackError);
+        }
+        return paths.size();
+    }
+
+    /**
+     * @brief Guesses the format from the first bytes of the data.
+     *
+     * A UTF-8 byte order mark and leading whitespace are skipped. '{' or '[' means JSON, '<' means
+     * XML, and otherwise the text is CSV if its first lines contain a delimiter (see
+     * detectDelimiter) or if it has several lines. UTF-16 and UTF-32 input is reported as Unknown.
+     * @param data The file contents or at least their beginning.
+     * @return The detected format.
+     */
+    static Format detectFormat(std::string_view data)
+    {
+        if (data.size() >= 2 && ((data[0] == '\xFF' && data[1] == '\xFE') || (data[0] == '\xFE' && data[1] == '\xFF')))
+        {
+            return Format::Unknown;
+        }
+        data = skipByteOrderMark(data);
+        size_t first = data.find_first_not_of(" \t\r\n");
+        if (first == std::string_view::npos)
+        {
+            return Format::Unknown;
+        }
+        char c = data[first];
+        if (c == '{' || c == '[')
+        {
+            return Format::JSON;
+        }
+        if (c == '<')
+        {
+            return Format::XML;
+        }
+        if (detectDelimiter(data) != 0)
+        {
+            return Format::CSV;
+        }
+        size_t newline = data.find('\n', first);
+        return newline != std::string_view::npos && data.find_first_not_of(" \t\r\n", newline) != std::string_view::npos
+                   ? Format::CSV
+                   : Format::Unknown;
+    }
+
+    /**
+     * @brief Picks the CSV delimiter among ',', ';', tab and '|' by counting them (outside quotes)
+     * on the first few lines; a delimiter occurring equally often on every line wins.
+     * @param data The CSV text or at least its beginning.
+     * @return The delimiter, or 0 if none of the candidates occurs.
+     */
+    static char detectDelimiter(std::string_view data)
+    {
+        constexpr char candidates[] = {',', ';', '\t', '|'};
+        constexpr size_t candidateCount = sizeof(candidates);
+        constexpr size_t sampleLines = 5;
+        size_t counts[sampleLines][candidateCount] = {};
+        size_t lines = 0;
+        bool inQuotes = false;
+        bool lineHasContent = false;
+        for (size_t i = 0; i < data.size() && i < 64 * 1024 && lines < sampleLines; ++i)
+        {
+            char c = data[i];
+            if (c == '"')
+            {
+                inQuotes = !inQuotes;
+            }
+            else if (c == '\n' && !inQuotes)
+            {
+                lines += lineHasContent ? 1 : 0;
+                lineHasContent = false;
+                continue;
+            }
+            else if (!inQuotes)
+            {
+                for (size_t k = 0; k < candidateCount; ++k)
+                {
+                    if (c == candidates[k])
+                        ++counts[lines][k];
+                }
+            }
+            lineHasContent = lineHasContent || c != '\r';
+        }
+        if (lineHasContent && lines < sampleLines)
+        {
+            ++lines;
+        }
+
+        char best = 0;
+        bool bestConsistent = false;
+        size_t bestCount = 0;
+        for (size_t k = 0; k < candidateCount; ++k)
+        {
+            size_t total = 0;
+            bool consistent = true;
+            for (size_t line = 0; line < lines; ++line)
+            {
+                total += counts[line][k];
+                consistent = consistent && counts[line][k] == counts[0][k];
+            }
+            if (total == 0)
+            {
+                continue;
+            }
+            // A delimiter with the same count on every line beats any inconsistent one
+            size_t count = consistent ? counts[0][k] : total;
+            if ((consistent && !bestConsistent) || (consistent == bestConsistent && count > bestCount))
+            {
+                best = candidates[k];
+                bestConsistent = consistent;
+                bestCount = count;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Parses a JSON file into a Document keeping arrays and nesting intact.
+     * The document references the memory-mapped file for unescaped strings and keeps the mapping
+     * alive, so only the tape and escaped strings are allocated.
+     * @param filepath The path to the JSON file.
+     * @return The parsed document.
+     * @throws std::runtime_error if the file cannot be read or is not valid JSON.
+     */
+    Document parseJSONDocument(const std::string &filepath)
+    {
+        try
+        {
+            auto file = std::make_shared<MappedFile>(readFile(filepath));
+            Document document = JsonParser::parseInPlace(file->view());
+            document.retainSource(file);
+            logger.log("JSON document parsed successfully.");
+            return document;
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error parsing JSON document: " + std::string(e.what()));
+            throw;
+        }
+    }
 
+    /**
+     * @brief Opens a JSON file for on-demand access: only the structural index is built, and
+     * fields are located and decoded when they are read.
+     * The reader keeps the memory-mapped file alive.
+     * @param filepath The path to the JSON file.
+     * @return The on-demand reader.
+     * @throws std::runtime_error if the file cannot be read or has an unterminated string.
+     */
+    JsonOnDemand parseJSONOnDemand(const std::string &filepath)
+    {
+        try
+        {
+            auto file = std::make_shared<MappedFile>(readFile(filepath));
+            JsonOnDemand reader(file->view());
+            reader.retainSource(file);
+            logger.log("JSON file indexed for on-demand access.");
+            return reader;
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error indexing JSON: " + std::string(e.what()));
+            throw;
+        }
+    }
+
+    /**
+     * @brief Parses an RFC 4180 CSV file and returns the cells flattened into "row/column" paths.
+     * Rows are numbered from 0 after the header, e.g. "0/name" is the name field of the first record.
+     * @param filepath The path to the CSV file.
+     * @return The flattened path to value map.
+     */
+    std::map<std::string, std::string> parseCSV(const std::string &filepath)
+    {
+        std::map<std::string, std::string> csvMap;
+        try
+        {
+            csvMap = csvPathMap(readFile(filepath).view(), CsvOptions());
             logger.log("CSV file parsed successfully.");
+            recordParsed(Format::CSV, csvMap);
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error parsing CSV: " + std::string(e.what()));
+        }
+        return csvMap;
+    }
+
+    /**
+     * @brief Parses CSV held in memory, e.g. an HTTP response body, like parseCSV does for files.
+     * @param data The CSV text.
+     * @param options The CSV dialect options.
+     * @return The flattened path to value map.
+     */
+    std::map<std::string, std::string> parseCSVBuffer(std::string_view data, const CsvOptions &options = CsvOptions())
+    {
+        std::map<std::string, std::string> csvMap;
+        try
+        {
+            csvMap = csvPathMap(data, options);
+            logger.log("CSV buffer parsed successfully.");
+            recordParsed(Format::CSV, csvMap);
         }
         catch (const std::exception &e)
         {
@@ -98,18 +581,151 @@ public:
     }
 
     /**
-     * @brief Parses an XML file and returns the parsed data as a string.
+     * @brief Parses an RFC 4180 CSV file into typed columns (Int64, Double or String).
+     * @param filepath The path to the CSV file.
+     * @param options The CSV dialect options.
+     * @return The parsed table.
+     * @throws std::runtime_error if the file cannot be read or is malformed.
+     */
+    CsvTable parseCSVTable(const std::string &filepath, const CsvOptions &options = CsvOptions())
+    {
+        try
+        {
+            CsvTable table = CsvParser::parse(readFile(filepath).view(), options);
+            logger.log("CSV table parsed successfully.");
+            return table;
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error parsing CSV table: " + std::string(e.what()));
+            throw;
+        }
+    }
+
+    /**
+     * @brief Parses a large CSV file on all cores by splitting the memory-mapped file into byte ranges.
+     * The result is identical to parseCSVTable; small files are parsed on the calling thread.
+     * @param filepath The path to the CSV file.
+     * @param options The CSV dialect options.
+     * @return The parsed table.
+     * @throws std::runtime_error if the file cannot be read or is malformed.
+     */
+    CsvTable parseCSVTableParallel(const std::string &filepath, const CsvOptions &options = CsvOptions())
+    {
+        try
+        {
+            MappedFile csvFile = readFile(filepath);
+            CsvTable table = CsvParser::parseParallel(csvFile.view(), workerPool(), options);
+            logger.log("CSV table parsed in parallel successfully.");
+            return table;
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error parsing CSV table in parallel: " + std::string(e.what()));
+            throw;
+        }
+    }
+
+    /**
+     * @brief Opens a columnar file written by writeColumnar. Uncompressed columns are read in place
+     * from the mapping, so this costs little more than validating the headers.
+     * @param filepath The path to the columnar file.
+     * @return The open file.
+     * @throws std::runtime_error if the file cannot be read or is not a valid columnar file.
+     */
+    ColumnarFile openColumnar(const std::string &filepath)
+    {
+        try
+        {
+            ColumnarFile columnar(filepath);
+            logger.log("Columnar file opened successfully.");
+            return columnar;
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error opening columnar file: " + std::string(e.what()));
+            throw;
+        }
+    }
+
+    /**
+     * @brief Loads a CSV table, reusing a columnar copy of it when one is up to date.
+     * The copy is used only if it was built with the same options from a CSV of the same size and
+     * modification time; otherwise the CSV is parsed in parallel and the copy is (re)written for
+     * the next run. A CSV modified just before it was read is not trusted to be unchanged later,
+     * so its copy is rebuilt on the next load.
+     * @param csvPath The path to the CSV file.
+     * @param columnarPath The path of the columnar copy.
+     * @param options The CSV dialect options.
+     * @return The table.
+     * @throws std::runtime_error if the CSV cannot be read or is malformed.
+     */
+    CsvTable loadCSVTable(const std::string &csvPath, const std::string &columnarPath, const CsvOptions &options = CsvOptions())
+    {
+        // Stamped before parsing, so a write during the parse makes the copy stale
+        std::error_code csvError;
+        uintmax_t csvSize = std::filesystem::file_size(csvPath, csvError);
+        auto csvTime = csvError ? std::filesystem::file_time_type() : std::filesystem::last_write_time(csvPath, csvError);
+        ColumnarSource source{csvSize, csvTime.time_since_epoch().count(), csvOptionsKey(options)};
+        std::error_code columnarError;
+        if (!csvError && std::filesystem::exists(columnarPath, columnarError))
+        {
+            try
+            {
+                ColumnarFile columnar = openColumnar(columnarPath);
+                const ColumnarSource &stored = columnar.source();
+                if (stored.modified != 0 && stored.modified == source.modified && stored.size == source.size && stored.options == source.options)
+                {
+                    return columnar.toTable();
+                }
+            }
+            catch (const std::exception &)
+            {
+                // Damaged or from another version; rebuild it below
+            }
+        }
+        CsvTable table = parseCSVTableParallel(csvPath, options);
+        if (csvError)
+        {
+            return table; // Appeared after the stat; there is no stamp to store
+        }
+        if (ParseCache<ParsedFile>::isRacy(csvTime))
+        {
+            source.modified = 0;
+        }
+        try
+        {
+            writeColumnar(table, columnarPath, false, source);
+        }
+        catch (const std::exception &)
+        {
+            // The table is still good; writeColumnar has logged why the copy was not saved
+        }
+        return table;
+    }
+
+    /**
+     * @brief Parses an XML file and returns element text and attributes keyed by "parent/child" paths.
+     * Attributes use "parent/child/@name"; repeated siblings are numbered from the second one ("item[2]").
      * @param filepath The path to the XML file.
-     * @return The parsed XML data as a string.
+     * @return The path to value map.
      */
     std::map<std::string, std::string> parseXML(const std::string &filepath)
     {
         std::map<std::string, std::string> xmlMap;
         try
         {
-            std::string xmlData = readFile(filepath);
-            parseXMLRecursive(xmlData, "", xmlMap);
+            if (fileCache)
+            {
+                xmlMap = loadParsed(filepath, Format::XML)->data;
+            }
+            else
+            {
+                MappedFile xmlFile = readFile(filepath);
+                collectXMLPaths(xmlFile.view(), xmlMap);
+            }
             logger.log("XML file parsed successfully.");
+            recordParsed(Format::XML, xmlMap);
         }
         catch (const std::exception &e)
         {
@@ -119,85 +735,440 @@ public:
     }
 
     /**
-     * @brief Writes the parsed data to a file.
-     * @param outputPath The path to the output file.
+     * @brief Parses XML held in memory, e.g. an HTTP response body, like parseXML does for files.
+     * @param data The XML text.
+     * @return The path to value map.
      */
-    void writeToFile(const std::string &outputPath)
+    std::map<std::string, std::string> parseXMLBuffer(std::string_view data)
     {
-        std::ofstream outFile(outputPath);
-        if (!outFile.is_open())
+        std::map<std::string, std::string> xmlMap;
+        try
+        {
+            collectXMLPaths(data, xmlMap);
+            logger.log("XML buffer parsed successfully.");
+            recordParsed(Format::XML, xmlMap);
+        }
+        catch (const std::exception &e)
         {
-            throw std::runtime_error("Error opening output file: " + outputPath);
+            logger.log("Error parsing XML: " + std::string(e.what()));
         }
+        return xmlMap;
+    }
 
-        outFile << "Parsed JSON Data:\n"
-                << jsonDataStream.str() << "\n";
-        outFile << "Parsed CSV Data:\n"
-                << csvDataStream.str() << "\n";
-        outFile << "Parsed XML Data:\n"
-                << xmlDataStream.str() << "\n";
+    /**
+     * @brief Parses an XML file into a Document (see XmlPullParser::parseDocument for the mapping).
+     * Like parseJSONDocument, the document keeps the memory-mapped file alive and points into it.
+     * @param filepath The path to the XML file.
+     * @return The parsed document.
+     * @throws std::runtime_error if the file cannot be read or is malformed.
+     */
+    Document parseXMLDocument(const std::string &filepath)
+    {
+        try
+        {
+            auto file = std::make_shared<MappedFile>(readFile(filepath));
+            Document document = XmlPullParser::parseDocumentInPlace(file->view());
+            document.retainSource(file);
+            logger.log("XML document parsed successfully.");
+            return document;
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error parsing XML document: " + std::string(e.what()));
+            throw;
+        }
+    }
 
-        logger.log("Data written to file successfully.");
+    /**
+     * @brief Streams a JSON file through the handler, reading it in fixed-size chunks.
+     * Memory use stays constant regardless of file size.
+     * @param filepath The path to the JSON file.
+     * @param handler The callbacks receiving the parse events.
+     * @param chunkSize The number of bytes read per chunk.
+     * @throws std::runtime_error if the file cannot be read or is not valid JSON.
+     */
+    void streamJSON(const std::string &filepath, const ParseHandler &handler, size_t chunkSize = defaultChunkSize)
+    {
+        JsonStreamParser parser(handler);
+        streamFile(filepath, parser, chunkSize, "JSON");
+    }
+
+    /**
+     * @brief Streams a CSV file through the handler, reading it in fixed-size chunks.
+     * Each record after the header is reported as one object keyed by the header fields.
+     * @param filepath The path to the CSV file.
+     * @param handler The callbacks receiving the parse events.
+     * @param chunkSize The number of bytes read per chunk.
+     * @throws std::runtime_error if the file cannot be read or is malformed.
+     */
+    void streamCSV(const std::string &filepath, const ParseHandler &handler, size_t chunkSize = defaultChunkSize)
+    {
+        CsvStreamParser parser(handler);
+        streamFile(filepath, parser, chunkSize, "CSV");
+    }
+
+    /**
+     * @brief Streams an XML file through the handler, reading it in fixed-size chunks.
+     * @param filepath The path to the XML file.
+     * @param handler The callbacks receiving the parse events.
+     * @param chunkSize The number of bytes read per chunk.
+     * @throws std::runtime_error if the file cannot be read or is malformed.
+     */
+    void streamXML(const std::string &filepath, const ParseHandler &handler, size_t chunkSize = defaultChunkSize)
+    {
+        XmlStreamParser parser(handler);
+        streamFile(filepath, parser, chunkSize, "XML");
+    }
+
+    /**
+     * @brief Writes a document as JSON to a file.
+     * @param document The document, e.g. from parseJSONDocument or parseXMLDocument.
+     * @param outputPath The path to the output file.
+     * @param pretty Whether to indent nested values.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writeJSON(const Document &document, const std::string &outputPath, bool pretty = false)
+    {
+        writeOutput(outputPath, "JSON", [&](OutputBuffer &out)
+                    { Serializer::writeJSON(document, out, pretty); });
+    }
+
+    /**
+     * @brief Writes a document as XML to a file (see Serializer::writeXML for the mapping).
+     * @param document The document, e.g. from parseXMLDocument or parseJSONDocument.
+     * @param outputPath The path to the output file.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writeXML(const Document &document, const std::string &outputPath)
+    {
+        writeOutput(outputPath, "XML", [&](OutputBuffer &out)
+                    { Serializer::writeXML(document, out); });
+    }
+
+    /**
+     * @brief Writes a table as CSV to a file.
+     * @param table The table, e.g. from parseCSVTable.
+     * @param outputPath The path to the output file.
+     * @param options The CSV dialect to write.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writeCSV(const CsvTable &table, const std::string &outputPath, const CsvOptions &options = CsvOptions())
+    {
+        writeOutput(outputPath, "CSV", [&](OutputBuffer &out)
+                    { Serializer::writeCSV(table, out, options); });
+    }
+
+    /**
+     * @brief Writes a table to a binary columnar file (see ColumnarFile for the layout).
+     * The file is written under a temporary name in the same directory and renamed over the
+     * destination, so a process reading the previous file (even mapped) never sees a partial one.
+     * @param table The table, e.g. from parseCSVTable.
+     * @param outputPath The path to the output file.
+     * @param compress Whether to varint-encode integer columns and string codes.
+     * @param source What the table was built from (see ColumnarSource).
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writeColumnar(const CsvTable &table, const std::string &outputPath, bool compress = false, const ColumnarSource &source = ColumnarSource())
+    {
+        std::string temporaryPath = outputPath + ".tmp" + std::to_string(std::random_device()());
+        try
+        {
+            writeOutput(temporaryPath, "Columnar data", [&](OutputBuffer &out)
+                        { ColumnarFile::write(table, out, compress, source); });
+            std::filesystem::rename(temporaryPath, outputPath);
+        }
+        catch (const std::exception &e)
+        {
+            std::error_code ignored;
+            std::filesystem::remove(temporaryPath, ignored);
+            logger.log("Error replacing columnar file " + outputPath + ": " + std::string(e.what()));
+            throw;
+        }
+    }
+
+    /**
+     * @brief Writes the results of the most recent successful parseJSON, parseCSV and parseXML
+     * calls (and their Buffer and format-detecting variants) to a file, one "path: value" per line.
+     * @param outputPath The path to the output file.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writeToFile(const std::string &outputPath)
+    {
+        writeOutput(outputPath, "Parsed data", [&](OutputBuffer &out)
+                    {
+            const std::pair<const char *, const std::map<std::string, std::string> *> sections[] = {
+                {"Parsed JSON Data:\n", &lastJSONData}, {"Parsed CSV Data:\n", &lastCSVData}, {"Parsed XML Data:\n", &lastXMLData}};
+            for (const auto &section : sections)
+            {
+                out.append(section.first);
+                for (const auto &[path, value] : *section.second)
+                {
+                    out.append(path);
+                    out.append(": ");
+                    out.append(value);
+                    out.append('\n');
+                }
+                out.append('\n');
+            } });
     }
 
 private:
-    std::ostringstream jsonDataStream; // Stream to store parsed JSON data
-    std::ostringstream csvDataStream;  // Stream to store parsed CSV data
-    std::ostringstream xmlDataStream;  // Stream to store parsed XML data
+    static constexpr size_t defaultChunkSize = 64 * 1024; // Read size used by the stream* methods
+    static constexpr size_t mapNodeOverhead = 64;         // Estimated bytes per std::map node besides its strings
+
+    std::unique_ptr<ThreadPool> pool; // Worker threads for parallel parsing, created on first use
+
+    std::unique_ptr<ParseCache<ParsedFile>> fileCache;   // Path maps by file, while caching is enabled
+    std::unique_ptr<ParseCache<Document>> documentCache; // Documents by file, while caching is enabled
+
+    std::map<std::string, std::string> lastJSONData; // Result of the latest successful JSON parse
+    std::map<std::string, std::string> lastCSVData;  // Result of the latest successful CSV parse
+    std::map<std::string, std::string> lastXMLData;  // Result of the latest successful XML parse
+
+    void recordParsed(Format format, const std::map<std::string, std::string> &data)
+    {
+        if (format == Format::JSON)
+            lastJSONData = data;
+        else if (format == Format::CSV)
+            lastCSVData = data;
+        else if (format == Format::XML)
+            lastXMLData = data;
+    }
+
+    template <typename Writer>
+    void writeOutput(const std::string &outputPath, const std::string &what, Writer &&write)
+    {
+        try
+        {
+            OutputBuffer out(outputPath);
+            write(out);
+            out.close();
+            logger.log(what + " written to file successfully.");
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error writing " + what + ": " + std::string(e.what()));
+            throw;
+        }
+    }
 
     /**
-     * @brief Reads the contents of a file and returns it as a string.
+     * @brief Maps the contents of a file into memory so parsers can read it without copying.
      * @param filepath The path to the file.
-     * @return The contents of the file as a string.
+     * @return The mapped file; its view() stays valid while the MappedFile is alive.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    MappedFile readFile(const std::string &filepath)
+    {
+        return MappedFile(filepath);
+    }
+
+    static std::string formatName(Format format)
+    {
+        switch (format)
+        {
+        case Format::JSON:
+            return "JSON";
+        case Format::CSV:
+            return "CSV";
+        case Format::XML:
+            return "XML";
+        default:
+            return "Unknown";
+        }
+    }
+
+    // Packs the CSV options into the value stored with a columnar copy
+    static uint64_t csvOptionsKey(const CsvOptions &options)
+    {
+        return static_cast<uint64_t>(static_cast<unsigned char>(options.delimiter)) |
+               static_cast<uint64_t>(static_cast<unsigned char>(options.quote)) << 8 |
+               static_cast<uint64_t>(options.hasHeader) << 16 | static_cast<uint64_t>(options.inferTypes) << 17;
+    }
+
+    // Flattens CSV with every column kept as text, so the map holds each field as written
+    // (leading zeros, long ids) rather than a reformatted inferred number
+    static std::map<std::string, std::string> csvPathMap(std::string_view data, CsvOptions options)
+    {
+        options.inferTypes = false;
+        return CsvParser::parse(data, options).toPathMap();
+    }
+
+    static std::string_view skipByteOrderMark(std::string_view data)
+    {
+        return data.substr(0, 3) == "\xEF\xBB\xBF" ? data.substr(3) : data;
+    }
+
+    /**
+     * @brief Parses data of a known format into a path map without logging (safe on worker threads).
+     * @throws std::runtime_error if the format is Unknown or the data is malformed.
      */
-    std::string readFile(const std::string &filepath)
+    static std::map<std::string, std::string> parseData(Format format, std::string_view data)
     {
-        std::ifstream file(filepath);
-        if (!file.is_open())
+        data = skipByteOrderMark(data);
+        std::map<std::string, std::string> dataMap;
+        switch (format)
+        {
+        case Format::JSON:
+            return JsonParser::parseInPlace(data).toPathMap();
+        case Format::CSV:
         {
-            throw std::runtime_error("Error opening file: " + filepath);
+            CsvOptions options;
+            char delimiter = detectDelimiter(data);
+            options.delimiter = delimiter == 0 ? ',' : delimiter;
+            return csvPathMap(data, options);
+        }
+        case Format::XML:
+            collectXMLPaths(data, dataMap);
+            return dataMap;
+        default:
+            throw std::runtime_error("Unrecognized file format");
         }
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        return buffer.str();
     }
 
     /**
-     * @brief Parses a line of CSV data and returns it as a string.
-     * @param line The line of CSV data.
-     * @return The parsed CSV line as a string.
+     * @brief Parses a file into a ParsedFile through the cache if it is enabled, without logging.
+     * The file is read into memory rather than mapped, so truncating it meanwhile cannot fault.
+     * @throws std::runtime_error if the file cannot be read or parsed.
      */
-    std::string parseCSVLine(const std::string &line)
+    std::shared_ptr<const ParsedFile> loadParsed(const std::string &filepath, Format format)
     {
-        std::regex csvRegex("(\"[^\"]*(\"\"[^\"]*)*\"|[^,]*)");
-        std::stringstream csvDataStream;
-        for (std::sregex_iterator it = std::sregex_iterator(line.begin(), line.end(), csvRegex); it != std::sregex_iterator(); ++it)
+        ParseCache<ParsedFile>::Loader load = [&](const std::shared_ptr<const MappedFile> &file)
+        {
+            ParsedFile parsed;
+            parsed.path = filepath;
+            parsed.format = format == Format::Unknown ? detectFormat(file->view()) : format;
+            parsed.data = parseData(parsed.format, file->view());
+            return parsed;
+        };
+        if (fileCache)
         {
-            csvDataStream << (*it)[0] << ",";
+            return fileCache->get(filepath, formatName(format), load);
         }
-        csvDataStream << "\n";
-        return csvDataStream.str();
+        return std::make_shared<const ParsedFile>(load(std::make_shared<const MappedFile>(MappedFile::copyOf(filepath))));
     }
 
-    void parseXMLRecursive(const std::string &xmlData, std::string currentPath, std::map<std::string, std::string> &xmlMap)
+    static ParsedFile parseFileQuietly(const std::string &path)
     {
-        std::regex xmlRegex("<([^/>]+)>([^<]*)</\\1>|<([^/>]+)>(.*)</\\3>");
-        std::smatch xmlMatch;
-        std::string::const_iterator searchStart(xmlData.cbegin());
+        ParsedFile result;
+        result.path = path;
+        try
+        {
+            MappedFile file(path);
+            result.format = detectFormat(file.view());
+            result.data = parseData(result.format, file.view());
+        }
+        catch (const std::exception &e)
+        {
+            result.error = e.what();
+        }
+        return result;
+    }
 
-        while (std::regex_search(searchStart, xmlData.cend(), xmlMatch, xmlRegex))
+    /**
+     * @brief Returns the worker pool, starting one thread per core on first use.
+     */
+    ThreadPool &workerPool()
+    {
+        if (!pool)
         {
-            if (xmlMatch[1].matched)
+            pool = std::make_unique<ThreadPool>();
+        }
+        return *pool;
+    }
+
+    /**
+     * @brief Feeds a file to a streaming parser one chunk at a time.
+     * @param filepath The path to the file.
+     * @param parser The JsonStreamParser, CsvStreamParser or XmlStreamParser receiving the bytes.
+     * @param chunkSize The number of bytes read per chunk.
+     * @param format The format name used in log messages.
+     */
+    template <typename StreamParser>
+    void streamFile(const std::string &filepath, StreamParser &parser, size_t chunkSize, const std::string &format)
+    {
+        try
+        {
+            std::ifstream file(filepath, std::ios::binary);
+            if (!file.is_open())
             {
-                std::string fullPath = currentPath + xmlMatch[1].str();
-                xmlMap[fullPath] = xmlMatch[2];
+                throw std::runtime_error("Error opening file: " + filepath);
             }
-            else if (xmlMatch[3].matched)
+            std::vector<char> buffer(chunkSize == 0 ? defaultChunkSize : chunkSize);
+            while (file)
+            {
+                file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                std::streamsize bytesRead = file.gcount();
+                if (bytesRead > 0)
+                {
+                    parser.feed(std::string_view(buffer.data(), static_cast<size_t>(bytesRead)));
+                }
+            }
+            parser.finish();
+            logger.log(format + " file streamed successfully.");
+        }
+        catch (const std::exception &e)
+        {
+            logger.log("Error streaming " + format + ": " + std::string(e.what()));
+            throw;
+        }
+    }
+
+    /**
+     * @brief Fills the path to value map from XML in a single pass of the pull tokenizer.
+     * @param xmlData The XML text.
+     * @param xmlMap The map receiving element text and attribute values.
+     */
+    static void collectXMLPaths(std::string_view xmlData, std::map<std::string, std::string> &xmlMap)
+    {
+        XmlPullParser parser(xmlData);
+        std::string path;                                                  // Path of the innermost open element
+        std::vector<size_t> parentPathLengths;                             // path.size() before each open element
+        std::vector<std::string> texts;                                    // Character data of each open element
+        std::vector<std::map<std::string_view, size_t>> siblingCounts(1); // Child name counts per open element
+
+        for (XmlPullParser::Event event = parser.next(); event != XmlPullParser::Event::EndDocument; event = parser.next())
+        {
+            switch (event)
+            {
+            case XmlPullParser::Event::StartElement:
             {
-                std::string nestedPath = currentPath + xmlMatch[3].str() + "/";
-                parseXMLRecursive(xmlMatch[4].str(), nestedPath, xmlMap);
+                size_t occurrence = ++siblingCounts.back()[parser.name()];
+                parentPathLengths.push_back(path.size());
+                if (!path.empty())
+                {
+                    path += '/';
+                }
+                path += parser.name();
+                if (occurrence > 1)
+                {
+                    path += "[" + std::to_string(occurrence) + "]";
+                }
+                for (const XmlPullParser::Attribute &attribute : parser.attributes())
+                {
+                    xmlMap[path + "/@" + std::string(attribute.name)] = attribute.value();
+                }
+                siblingCounts.emplace_back();
+                texts.emplace_back();
+                break;
+            }
+            case XmlPullParser::Event::EndElement:
+                if (!texts.back().empty())
+                {
+                    xmlMap[path] = std::move(texts.back());
+                }
+                texts.pop_back();
+                siblingCounts.pop_back();
+                path.resize(parentPathLengths.back());
+                parentPathLengths.pop_back();
+                break;
+            case XmlPullParser::Event::Text:
+            case XmlPullParser::Event::CData:
+                texts.back() += parser.text(event);
+                break;
+            default:
+                break;
             }
-            searchStart = xmlMatch.suffix().first;
         }
     }
 };
@@ -1,74 +1,162 @@
-#include <filesystem>
-#include <thread>
-#include <atomic>
+#ifndef FILESYSTEMWATCHER_HPP
+#define FILESYSTEMWATCHER_HPP
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
 #include "Logger.hpp"
+#include "WatchService.hpp"
 
 /**
  * @brief A class for watching changes in a specified directory.
+ *
+ * Each watcher is one watch on a WatchService, by default the process-wide one, so any number of
+ * watchers share a single thread (and on Linux a single inotify descriptor). On Linux changes are
+ * read from inotify and reported within milliseconds; elsewhere, or when requested, the directory
+ * is polled and successive DirectorySnapshots are diffed, so only changed entries produce events.
+ * Either way the callback runs on the service thread and receives typed create/modify/delete/rename
+ * events, after the include/exclude filters and debouncing of the WatchOptions are applied.
  */
 class FileSystemWatcher {
+public:
+    using Callback = std::function<void(const FileSystemEvent &)>;
+    using BatchCallback = WatchService::BatchCallback;
+
+private:
     Logger logger; // Logger instance for logging events
-    std::thread watcherThread; // Thread for watching the directory
-    std::atomic<bool> isWatching; // Flag to indicate if the watcher is active
+    std::mutex logMutex; // Serializes logging between the caller and the service thread
+    WatchService& service; // Runs the watch
+    WatchService::WatchId watchId = 0; // The current watch, 0 if not watching
+    bool nativeBackend = false; // Whether the current watch uses inotify
 
 public:
     /**
-     * @brief Constructs a FileSystemWatcher object.
-     * 
-     * Initializes the logger and sets the isWatching flag to false.
+     * @brief Constructs a FileSystemWatcher object that uses the shared WatchService.
+     */
+    FileSystemWatcher() : FileSystemWatcher(WatchService::shared()) {}
+
+    /**
+     * @brief Constructs a FileSystemWatcher object that uses the given WatchService, which must
+     * outlive it.
      */
-    FileSystemWatcher()
+    explicit FileSystemWatcher(WatchService& service)
         : logger([]() {
             std::string currentFile = __FILE__;
             std::string::size_type pos = currentFile.find_last_of("/\\");
             std::string fileName = currentFile.substr(pos + 1, currentFile.rfind(".") - pos - 1);
             std::string logFilename = Logger::getLogsFilename(fileName);
             return logFilename;
-        }()), 
-          isWatching(false)
+        }()),
+          service(service)
     {
         logger.log("FileSystemWatcher instance created");
     }
 
+    FileSystemWatcher(const FileSystemWatcher &) = delete;
+    FileSystemWatcher &operator=(const FileSystemWatcher &) = delete;
+
     /**
      * @brief Destroys the FileSystemWatcher object.
-     * 
+     *
      * Stops watching the directory if it is currently being watched.
      */
     ~FileSystemWatcher() {
-        if (isWatching) {
-            stopWatching();
-        }
+        stopWatching();
     }
 
     /**
      * @brief Starts watching the specified directory for file changes.
-     * 
+     * Any directory watched before is no longer watched.
+     *
      * @param directory The directory to watch.
+     * @param onEvent Called on the service thread for each change; if empty, changes are logged.
+     * @param options Recursion, backend selection, polling interval, debouncing and filters.
+     * @throws std::runtime_error if the directory does not exist.
      */
-    void startWatching(const std::string& directory) {
-        isWatching = true;
-        watcherThread = std::thread([this, directory]() {
-            while (isWatching) {
-                for (const auto & entry : std::filesystem::directory_iterator(directory)) {
-                    logger.log("Found file: " + entry.path().string());
+    void startWatching(std::string directory, Callback onEvent = nullptr, const WatchOptions& options = WatchOptions()) {
+        start(std::move(directory), [this, onEvent = std::move(onEvent)](const std::vector<FileSystemEvent>& events) {
+            for (const FileSystemEvent& event : events) {
+                if (!onEvent) {
+                    log(std::string(typeName(event.type)) + ": " + (event.oldPath.empty() ? "" : event.oldPath + " -> ") + event.path);
+                    continue;
                 }
-                std::this_thread::sleep_for(std::chrono::seconds(1)); // Sleep for a while
+                try {
+                    onEvent(event);
+                } catch (const std::exception& e) {
+                    log("Watcher callback failed for " + event.path + ": " + e.what());
+                }
+            }
+        }, options);
+    }
+
+    /**
+     * @brief Starts watching the specified directory, delivering changes in batches.
+     * A batch holds the events read or scanned together or, with a debounce window, the coalesced
+     * events of one window in the order their paths first changed.
+     *
+     * @param directory The directory to watch.
+     * @param onBatch Called on the service thread with each non-empty batch.
+     * @param options Recursion, backend selection, polling interval, debouncing and filters.
+     * @throws std::runtime_error if the directory does not exist.
+     */
+    void startWatchingBatched(std::string directory, BatchCallback onBatch, const WatchOptions& options = WatchOptions()) {
+        start(std::move(directory), [this, onBatch = std::move(onBatch)](const std::vector<FileSystemEvent>& events) {
+            try {
+                onBatch(events);
+            } catch (const std::exception& e) {
+                log("Watcher callback failed for a batch of " + std::to_string(events.size()) + " events: " + e.what());
             }
-        });
-        logger.log("Started watching " + directory);
+        }, options);
     }
 
     /**
      * @brief Stops watching the directory.
+     * Events still held back for debouncing are delivered first.
      */
     void stopWatching() {
-        isWatching = false;
-        if (watcherThread.joinable()) {
-            watcherThread.join();
+        if (watchId != 0) {
+            service.removeWatch(watchId);
+            watchId = 0;
+            log("Stopped watching");
         }
-        logger.log("Stopped watching");
     }
 
-    // Additional methods as needed
-};
\ No newline at end of file
+    /**
+     * @brief Returns whether the running watcher uses the native (inotify) backend.
+     */
+    bool usesNativeBackend() const {
+        return nativeBackend;
+    }
+
+    /**
+     * @brief Returns the name of an event type, e.g. "Created".
+     */
+    static const char *typeName(FileSystemEvent::Type type) {
+        switch (type) {
+        case FileSystemEvent::Type::Created: return "Created";
+        case FileSystemEvent::Type::Modified: return "Modified";
+        case FileSystemEvent::Type::Deleted: return "Deleted";
+        default: return "Renamed";
+        }
+    }
+
+private:
+    void start(std::string directory, BatchCallback onBatch, const WatchOptions& options) {
+        stopWatching();
+        try {
+            watchId = service.addWatch(std::move(directory), std::move(onBatch), options);
+        } catch (const std::exception& e) {
+            log(e.what());
+            throw;
+        }
+        nativeBackend = service.isNative(watchId);
+    }
+
+    void log(const std::string& message) {
+        std::lock_guard<std::mutex> lock(logMutex);
+        logger.log(message);
+    }
+};
+
+#endif // FILESYSTEMWATCHER_HPP
@@ -0,0 +1,329 @@
+#ifndef HOTRELOADER_HPP
+#define HOTRELOADER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Logger.hpp"
+#include "FileParser.hpp"
+#include "FileSystemWatcher.hpp"
+#include "EventHandlingSystem.hpp"
+
+/**
+ * @brief The payload of the event published by HotReloader for each change to a watched file.
+ */
+struct ConfigReload
+{
+    std::string path;                                   // The absolute path of the watched file
+    std::shared_ptr<const FileParser::ParsedFile> file; // The current content; the previous one after a failed parse, null once removed
+    std::vector<std::string> changedKeys;               // Paths whose value was added or changed, in order
+    std::vector<std::string> removedKeys;               // Paths that no longer exist, in order
+    bool removed = false;                               // The file was deleted or moved away
+    std::string error;                                  // Empty on success, otherwise why the file could not be parsed
+};
+
+/**
+ * @brief The HotReloader class keeps parsed copies of configuration files up to date and
+ * publishes every change through an EventHandlingSystem.
+ *
+ * Files are watched through FileSystemWatcher (so all reloaders share the WatchService thread)
+ * with a short debounce window, which turns an editor's write-to-temporary-and-rename save into
+ * one reload. Re-parsing happens on the reloader's own thread, one changed file at a time, through
+ * a FileParser whose cache recognizes a file rewritten with identical content. Files are read into
+ * memory rather than mapped, so a file truncated by an editor while it is being re-parsed yields
+ * a parse error or a short read, never a crash. The new path map is
+ * compared with the previous one in a single merge pass and only the keys that changed are
+ * reported; a reload that changes nothing publishes nothing. A file that fails to parse keeps its
+ * previous content and publishes the error.
+ *
+ * Event handlers run on the reloader thread while the EventHandlingSystem is locked, so they should
+ * be quick; they may be registered at any time. current() can be called from any thread and never
+ * waits for a reload.
+ */
+class HotReloader
+{
+public:
+    static constexpr std::chrono::milliseconds defaultDebounce{50}; // Default quiet period before a reload
+
+    /**
+     * @brief Constructs a HotReloader object.
+     * @param events Receives the reload events; it must outlive the reloader.
+     * @param eventName The name under which ConfigReload events are triggered.
+     * @param debounce How long a file must be left alone before it is re-parsed.
+     * @throws std::runtime_error if the event is registered with a payload other than ConfigReload.
+     */
+    explicit HotReloader(EventHandlingSystem &events, const std::string &eventName = "configReloaded", std::chrono::milliseconds debounce = defaultDebounce)
+        : logger([]()
+                 {
+            std::string currentFile = __FILE__;
+            std::string::size_type pos = currentFile.find_last_of("/\\");
+            std::string fileName = currentFile.substr(pos + 1, currentFile.rfind(".") - pos - 1);
+            std::string logFilename = Logger::getLogsFilename(fileName);
+            return logFilename; }()),
+          events(events), reloaded(events.handle<ConfigReload>(eventName)), debounce(debounce)
+    {
+        parser.enableCache();
+        worker = std::thread([this]()
+                             { run(); });
+        log("HotReloader instance created");
+    }
+
+    HotReloader(const HotReloader &) = delete;
+    HotReloader &operator=(const HotReloader &) = delete;
+
+    /**
+     * @brief Stops watching, finishes the reloads already queued and joins the reloader thread.
+     */
+    ~HotReloader()
+    {
+        watchers.clear(); // No new work once the watchers have stopped
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeup.notify_one();
+        worker.join();
+    }
+
+    /**
+     * @brief Starts watching a file. It is parsed right away on the reloader thread, which
+     * publishes its whole content as changed keys.
+     * @param filepath The file; its directory must exist, the file itself may appear later.
+     * @throws std::runtime_error if the directory does not exist.
+     */
+    void watch(const std::string &filepath)
+    {
+        std::string path = std::filesystem::absolute(filepath).lexically_normal().string();
+        std::string directory = std::filesystem::path(path).parent_path().string();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!files.emplace(path, nullptr).second)
+            {
+                return;
+            }
+        }
+        std::unique_ptr<FileSystemWatcher> &watcher = watchers[directory];
+        if (!watcher)
+        {
+            WatchOptions options;
+            options.debounce = debounce;
+            try
+            {
+                watcher = std::make_unique<FileSystemWatcher>();
+                watcher->startWatchingBatched(directory, [this](const std::vector<FileSystemEvent> &batch)
+                                              { onChanges(batch); }, options);
+            }
+            catch (const std::exception &e)
+            {
+                watchers.erase(directory);
+                std::lock_guard<std::mutex> lock(mutex);
+                files.erase(path);
+                log("Cannot watch " + filepath + ": " + e.what());
+                throw;
+            }
+        }
+        schedule(path);
+        log("Watching " + path);
+    }
+
+    /**
+     * @brief Returns the latest successfully parsed content of a watched file.
+     * @param filepath The file, as passed to watch().
+     * @return The content, or null if the file is not watched, not loaded yet or removed.
+     */
+    std::shared_ptr<const FileParser::ParsedFile> current(const std::string &filepath) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = files.find(std::filesystem::absolute(filepath).lexically_normal().string());
+        return found == files.end() ? nullptr : found->second;
+    }
+
+private:
+    Logger logger; // Logger instance for logging events
+    std::mutex logMutex; // Serializes logging between the caller and the reloader thread
+    EventHandlingSystem &events;
+    EventHandlingSystem::EventHandle<ConfigReload> reloaded;
+    std::chrono::milliseconds debounce;
+    FileParser parser; // Used by the reloader thread only
+    std::map<std::string, std::unique_ptr<FileSystemWatcher>> watchers; // One per directory; used by the caller's thread only
+
+    mutable std::mutex mutex; // Guards the members below
+    std::condition_variable wakeup;
+    std::unordered_map<std::string, std::shared_ptr<const FileParser::ParsedFile>> files; // Watched files and their content
+    std::deque<std::string> queue; // Files to reload, oldest change first
+    std::unordered_set<std::string> queued; // The files in queue
+    bool stopping = false;
+    std::thread worker;
+
+    void log(const std::string &message)
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        logger.log(message);
+    }
+
+    // Runs on the WatchService thread, so it only queues the affected files
+    void onChanges(const std::vector<FileSystemEvent> &batch)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const FileSystemEvent &event : batch)
+        {
+            for (const std::string *path : {&event.path, &event.oldPath})
+            {
+                if (!path->empty() && files.count(*path) && queued.insert(*path).second)
+                {
+                    queue.push_back(*path);
+                }
+            }
+        }
+        if (!queue.empty())
+        {
+            wakeup.notify_one();
+        }
+    }
+
+    void schedule(const std::string &path)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!queued.insert(path).second)
+            {
+                return;
+            }
+            queue.push_back(path);
+        }
+        wakeup.notify_one();
+    }
+
+    void run()
+    {
+        while (true)
+        {
+            std::string path;
+            std::shared_ptr<const FileParser::ParsedFile> previous;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeup.wait(lock, [this]()
+                            { return stopping || !queue.empty(); });
+                if (queue.empty())
+                {
+                    return;
+                }
+                path = std::move(queue.front());
+                queue.pop_front();
+                queued.erase(path);
+                previous = files[path];
+            }
+            reload(path, previous);
+        }
+    }
+
+    void reload(const std::string &path, const std::shared_ptr<const FileParser::ParsedFile> &previous)
+    {
+        ConfigReload reload;
+        reload.path = path;
+        reload.file = previous;
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(path, error))
+        {
+            if (!previous)
+            {
+                return; // Not there yet
+            }
+            reload.file = nullptr;
+            reload.removed = true;
+            reload.removedKeys.reserve(previous->data.size());
+            for (const auto &entry : previous->data)
+            {
+                reload.removedKeys.push_back(entry.first);
+            }
+        }
+        else
+        {
+            try
+            {
+                reload.file = parser.parseCached(path);
+            }
+            catch (const std::exception &e)
+            {
+                reload.error = e.what();
+            }
+            if (reload.error.empty())
+            {
+                if (reload.file == previous)
+                {
+                    return; // Same content, served by the cache
+                }
+                diff(previous, *reload.file, reload);
+                if (previous && reload.changedKeys.empty() && reload.removedKeys.empty())
+                {
+                    store(path, reload.file); // e.g. only whitespace changed
+                    return;
+                }
+            }
+        }
+        if (reload.error.empty())
+        {
+            store(path, reload.file);
+        }
+        log(reload.error.empty() ? "Reloaded " + path + ": " + std::to_string(reload.changedKeys.size()) + " changed, " + std::to_string(reload.removedKeys.size()) + " removed"
+                                 : "Error reloading " + path + ": " + reload.error);
+        try
+        {
+            events.triggerEvent(reloaded, reload);
+        }
+        catch (const std::exception &e)
+        {
+            log("Reload event for " + path + " failed: " + e.what());
+        }
+    }
+
+    void store(const std::string &path, std::shared_ptr<const FileParser::ParsedFile> file)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = files.find(path);
+        if (found != files.end())
+        {
+            found->second = std::move(file);
+        }
+    }
+
+    // Compares two sorted path maps in one pass
+    static void diff(const std::shared_ptr<const FileParser::ParsedFile> &previous, const FileParser::ParsedFile &current, ConfigReload &reload)
+    {
+        static const std::map<std::string, std::string> none;
+        const std::map<std::string, std::string> &before = previous ? previous->data : none;
+        auto old = before.begin();
+        auto now = current.data.begin();
+        while (old != before.end() || now != current.data.end())
+        {
+            if (now == current.data.end() || (old != before.end() && old->first < now->first))
+            {
+                reload.removedKeys.push_back((old++)->first);
+            }
+            else if (old == before.end() || now->first < old->first)
+            {
+                reload.changedKeys.push_back((now++)->first);
+            }
+            else
+            {
+                if (old->second != now->second)
+                {
+                    reload.changedKeys.push_back(now->first);
+                }
+                ++old;
+                ++now;
+            }
+        }
+    }
+};
+
+#endif // HOTRELOADER_HPP
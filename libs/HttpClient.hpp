@@ -10,6 +10,9 @@
 
 #include <iostream> // Include the iostream library for input/output operations
 #include <string> // Include the string library for string manipulation
+#include <string_view> // Include the string_view library for response chunks
+#include <functional> // Include the functional library for chunk callbacks
+#include <exception> // Include the exception library to carry callback errors across curl
 #include <curl/curl.h> // Include the curl library for making HTTP requests
 #include "Logger.hpp" // Include the Logger header file for logging events
 
@@ -61,6 +64,42 @@ public:
         return performRequest(url, "GET");
     }
 
+    /**
+     * @brief Sends a GET request and hands the response body to a callback as chunks arrive.
+     *
+     * Nothing is buffered: each chunk can be fed straight into a streaming parser, e.g.
+     * `httpClient.getRequestStream(url, [&](std::string_view chunk) { parser.feed(chunk); });`.
+     * An exception thrown by the callback aborts the transfer and is rethrown to the caller.
+     *
+     * @param url The URL to send the request to.
+     * @param onChunk Called with each piece of the response body, in order.
+     * @return True if the transfer completed, false if the request failed.
+     */
+    bool getRequestStream(const std::string& url, const std::function<void(std::string_view)>& onChunk) {
+        logger.log("Sending streaming GET request to " + url);
+        if (!curl) {
+            return false;
+        }
+        ChunkSink sink{&onChunk, nullptr};
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, chunkCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &sink);
+
+        CURLcode res = curl_easy_perform(curl);
+        if (sink.error) {
+            logger.log("Streaming GET aborted by the chunk callback.");
+            std::rethrow_exception(sink.error);
+        }
+        if (res != CURLE_OK) {
+            std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
+            logger.log("curl_easy_perform() failed: " + std::string(curl_easy_strerror(res)));
+            return false;
+        }
+        logger.log("Streaming HTTP request performed successfully.");
+        return true;
+    }
+
     /**
      * @brief Sends a POST request to the specified URL with the given data.
      * 
@@ -107,6 +146,37 @@ private:
         }
     }
 
+    /**
+     * @brief Destination of a streaming request: the user callback and the first error it threw.
+     */
+    struct ChunkSink {
+        const std::function<void(std::string_view)>* onChunk;
+        std::exception_ptr error;
+    };
+
+    /**
+     * @brief Callback function forwarding response data to a ChunkSink.
+     * 
+     * Exceptions must not unwind through curl, so they are stored in the sink and the transfer is
+     * aborted by returning 0.
+     * 
+     * @param contents Pointer to the response data.
+     * @param size Size of each element in the response data.
+     * @param nmemb Number of elements in the response data.
+     * @param sink Pointer to the ChunkSink receiving the data.
+     * @return The number of bytes consumed, or 0 to abort.
+     */
+    static size_t chunkCallback(void* contents, size_t size, size_t nmemb, ChunkSink* sink) {
+        size_t length = size * nmemb;
+        try {
+            (*sink->onChunk)(std::string_view(static_cast<const char*>(contents), length));
+            return length;
+        } catch (...) {
+            sink->error = std::current_exception();
+            return 0;
+        }
+    }
+
     /**
      * @brief Performs an HTTP request to the specified URL with the given method and data.
      * 
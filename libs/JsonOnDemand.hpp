@@ -0,0 +1,416 @@
+#ifndef JSONONDEMAND_HPP
+#define JSONONDEMAND_HPP
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Document.hpp"
+#include "JsonParser.hpp"
+
+/**
+ * @brief The JsonOnDemand class reads individual fields of a JSON text without building a tree.
+ *
+ * Construction runs only stage 1 of JsonParser (the SIMD structural index). Values are cheap
+ * handles onto that index; navigating to a member or element skips every sibling subtree by
+ * matching brackets on the index, so unrelated parts of the input are never looked at again and
+ * strings and numbers are only decoded when a getter asks for them. Validation is equally lazy:
+ * malformed JSON is reported only if the accessed path runs into it.
+ *
+ * The JSON text must outlive the JsonOnDemand object and every Value obtained from it;
+ * retainSource() can tie the two together.
+ */
+class JsonOnDemand
+{
+public:
+    /**
+     * @brief A handle to one value of the input. Values are invalidated with their JsonOnDemand.
+     */
+    class Value
+    {
+    public:
+        /**
+         * @brief Forward iterator over the elements of an array or the member values of an object.
+         */
+        class Iterator
+        {
+        public:
+            Iterator(const JsonOnDemand *reader, uint32_t position, bool inObject)
+                : reader(reader), position(position), inObject(inObject) {}
+
+            Value operator*() const
+            {
+                return inObject ? Value(reader, position + 2, position) : Value(reader, position, noKey);
+            }
+
+            Iterator &operator++()
+            {
+                position = reader->nextSibling(inObject ? position + 2 : position, inObject);
+                return *this;
+            }
+
+            bool operator==(const Iterator &other) const { return position == other.position; }
+            bool operator!=(const Iterator &other) const { return position != other.position; }
+
+        private:
+            const JsonOnDemand *reader;
+            uint32_t position; // Structural index of the element or member key; endPosition when done
+            bool inObject;
+        };
+
+        /**
+         * @brief Returns the type, judged from the first character only.
+         */
+        Document::Type type() const
+        {
+            switch (reader->charAt(position))
+            {
+            case '{':
+                return Document::Type::Object;
+            case '[':
+                return Document::Type::Array;
+            case '"':
+                return Document::Type::String;
+            case 't':
+            case 'f':
+                return Document::Type::Boolean;
+            case 'n':
+                return Document::Type::Null;
+            default:
+                return Document::Type::Number;
+            }
+        }
+
+        bool isNull() const { return type() == Document::Type::Null; }
+        bool isBool() const { return type() == Document::Type::Boolean; }
+        bool isNumber() const { return type() == Document::Type::Number; }
+        bool isString() const { return type() == Document::Type::String; }
+        bool isArray() const { return type() == Document::Type::Array; }
+        bool isObject() const { return type() == Document::Type::Object; }
+
+        /**
+         * @brief Returns the decoded member name (empty for array elements and the root).
+         */
+        std::string key() const
+        {
+            return keyPosition == noKey ? std::string() : reader->decodeString(keyPosition);
+        }
+
+        /**
+         * @brief Decodes the string value.
+         * @throws std::runtime_error if the value is not a string or has an invalid escape.
+         */
+        std::string getString() const
+        {
+            expect(Document::Type::String, "string");
+            return reader->decodeString(position);
+        }
+
+        /**
+         * @brief Returns the string body without decoding escapes, pointing into the input.
+         * @throws std::runtime_error if the value is not a string.
+         */
+        std::string_view getRawString() const
+        {
+            expect(Document::Type::String, "string");
+            return JsonParser::stringBodyAt(reader->json, reader->offsetOf(position));
+        }
+
+        /**
+         * @brief Parses the numeric value.
+         * @throws std::runtime_error if the value is not a valid number.
+         */
+        double getNumber() const
+        {
+            expect(Document::Type::Number, "number");
+            return JsonParser::parseNumber(JsonParser::scalarAt(reader->json, reader->offsetOf(position)));
+        }
+
+        /**
+         * @brief Returns the boolean value.
+         * @throws std::runtime_error if the value is not true or false.
+         */
+        bool getBool() const
+        {
+            std::string_view literal = JsonParser::scalarAt(reader->json, reader->offsetOf(position));
+            if (literal != "true" && literal != "false")
+            {
+                reader->fail("expected a boolean", position);
+            }
+            return literal == "true";
+        }
+
+        /**
+         * @brief Finds a member of an object, skipping the values of all members before it.
+         * @return The member value, or std::nullopt if it does not exist or this is not an object.
+         */
+        std::optional<Value> find(std::string_view memberKey) const
+        {
+            if (!isObject())
+            {
+                return std::nullopt;
+            }
+            for (Iterator it = begin(); it != end(); ++it)
+            {
+                Value member = *it;
+                if (reader->keyEquals(member.keyPosition, memberKey))
+                {
+                    return member;
+                }
+            }
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Returns a member of an object.
+         * @throws std::out_of_range if there is no such member.
+         */
+        Value operator[](std::string_view memberKey) const
+        {
+            std::optional<Value> member = find(memberKey);
+            if (!member)
+            {
+                throw std::out_of_range("JSON key not found: " + std::string(memberKey));
+            }
+            return *member;
+        }
+
+        /**
+         * @brief Returns an element of an array, skipping the elements before it.
+         * @throws std::out_of_range if the array is shorter or this is not an array.
+         */
+        Value operator[](size_t index) const
+        {
+            if (isArray())
+            {
+                size_t current = 0;
+                for (Iterator it = begin(); it != end(); ++it, ++current)
+                {
+                    if (current == index)
+                    {
+                        return *it;
+                    }
+                }
+            }
+            throw std::out_of_range("JSON index out of range: " + std::to_string(index));
+        }
+
+        /**
+         * @brief Counts the elements or members by skipping over them (0 for scalars).
+         */
+        size_t size() const
+        {
+            size_t count = 0;
+            if (isArray() || isObject())
+            {
+                for (Iterator it = begin(); it != end(); ++it)
+                {
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        Iterator begin() const
+        {
+            bool inObject = isObject();
+            if (!inObject && !isArray())
+            {
+                return end();
+            }
+            if (reader->charAt(position + 1) == (inObject ? '}' : ']'))
+            {
+                return end();
+            }
+            if (inObject)
+            {
+                reader->checkMember(position + 1);
+            }
+            return Iterator(reader, position + 1, inObject);
+        }
+
+        Iterator end() const { return Iterator(reader, endPosition, isObject()); }
+
+        /**
+         * @brief Returns the exact text of this value in the input, including nested content.
+         */
+        std::string_view rawJson() const
+        {
+            size_t start = reader->offsetOf(position);
+            char c = reader->charAt(position);
+            size_t end;
+            if (c == '{' || c == '[')
+                end = reader->offsetOf(reader->skip(position) - 1) + 1;
+            else if (c == '"')
+                end = start + JsonParser::stringBodyAt(reader->json, start).size() + 2;
+            else
+                end = start + JsonParser::scalarAt(reader->json, start).size();
+            return reader->json.substr(start, end - start);
+        }
+
+        /**
+         * @brief Fully parses this value into a Document, e.g. once a small subtree has been located.
+         */
+        Document toDocument() const { return JsonParser::parse(rawJson()); }
+
+    private:
+        friend class JsonOnDemand;
+
+        const JsonOnDemand *reader;
+        uint32_t position;    // Structural index of the first character of the value
+        uint32_t keyPosition; // Structural index of the member key, or noKey
+
+        Value(const JsonOnDemand *reader, uint32_t position, uint32_t keyPosition)
+            : reader(reader), position(position), keyPosition(keyPosition)
+        {
+            if (position >= reader->structurals.size())
+            {
+                throw std::runtime_error("Unexpected end of JSON input");
+            }
+        }
+
+        void expect(Document::Type expected, const char *name) const
+        {
+            if (type() != expected)
+            {
+                reader->fail(std::string("expected a ") + name, position);
+            }
+        }
+    };
+
+    /**
+     * @brief Indexes the JSON text (stage 1 only).
+     * @param json The JSON text; it must outlive this object.
+     * @throws std::runtime_error if the input is empty, too large or has an unterminated string.
+     */
+    explicit JsonOnDemand(std::string_view json)
+        : json(json), structurals(JsonParser::findStructuralIndices(json))
+    {
+        if (structurals.empty())
+        {
+            throw std::runtime_error("Empty JSON document");
+        }
+    }
+
+    /**
+     * @brief Returns the top-level value.
+     */
+    Value root() const { return Value(this, 0, noKey); }
+
+    /**
+     * @brief Keeps the buffer the reader points into alive as long as the reader.
+     * @param owner Shared ownership of the input, e.g. a MappedFile or a response body.
+     */
+    void retainSource(std::shared_ptr<const void> owner) { source = std::move(owner); }
+
+private:
+    static constexpr uint32_t noKey = UINT32_MAX;
+    static constexpr uint32_t endPosition = UINT32_MAX; // Iterator position after the last child
+
+    std::string_view json;
+    std::vector<uint32_t> structurals;  // Stage-1 index into json
+    std::shared_ptr<const void> source; // Owner of json, if retained
+
+    size_t offsetOf(uint32_t position) const { return structurals[position]; }
+
+    char charAt(uint32_t position) const
+    {
+        if (position >= structurals.size())
+        {
+            throw std::runtime_error("Unexpected end of JSON input");
+        }
+        return json[structurals[position]];
+    }
+
+    [[noreturn]] void fail(const std::string &message, uint32_t position) const
+    {
+        size_t offset = position < structurals.size() ? structurals[position] : json.size();
+        throw std::runtime_error("Invalid JSON at offset " + std::to_string(offset) + ": " + message);
+    }
+
+    // Returns the structural index just past the value at position. Containers are skipped by
+    // counting bracket depth on the index, which holds no string contents; the skipped interior is
+    // not validated beyond that.
+    uint32_t skip(uint32_t position) const
+    {
+        char open = charAt(position);
+        if (open != '{' && open != '[')
+        {
+            if (open == '}' || open == ']' || open == ',' || open == ':')
+            {
+                fail("expected value", position);
+            }
+            return position + 1;
+        }
+        size_t depth = 0;
+        uint32_t i = position;
+        char c;
+        do
+        {
+            c = charAt(i++);
+            if (c == '{' || c == '[')
+                ++depth;
+            else if (c == '}' || c == ']')
+                --depth;
+        } while (depth > 0);
+        if (c != (open == '{' ? '}' : ']'))
+        {
+            fail("mismatched closing bracket", i - 1);
+        }
+        return i;
+    }
+
+    // Given the structural index of an element (or of a member's value), returns the index of the
+    // next element (or member key), or endPosition at the closing bracket.
+    uint32_t nextSibling(uint32_t valuePosition, bool inObject) const
+    {
+        uint32_t after = skip(valuePosition);
+        char c = charAt(after);
+        if (c == ',')
+        {
+            if (inObject)
+            {
+                checkMember(after + 1);
+            }
+            return after + 1;
+        }
+        if (c != (inObject ? '}' : ']'))
+        {
+            fail("expected ',' or closing bracket", after);
+        }
+        return endPosition;
+    }
+
+    void checkMember(uint32_t keyPosition) const
+    {
+        if (charAt(keyPosition) != '"')
+        {
+            fail("expected object key", keyPosition);
+        }
+        if (charAt(keyPosition + 1) != ':')
+        {
+            fail("expected ':'", keyPosition + 1);
+        }
+    }
+
+    std::string decodeString(uint32_t position) const
+    {
+        return JsonParser::unescape(JsonParser::stringBodyAt(json, offsetOf(position)));
+    }
+
+    bool keyEquals(uint32_t keyPosition, std::string_view expected) const
+    {
+        checkMember(keyPosition);
+        std::string_view body = JsonParser::stringBodyAt(json, offsetOf(keyPosition));
+        if (body.find('\\') == std::string_view::npos)
+        {
+            return body == expected;
+        }
+        return JsonParser::unescape(body) == expected;
+    }
+};
+
+#endif // JSONONDEMAND_HPP
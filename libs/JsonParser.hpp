@@ -0,0 +1,601 @@
+#ifndef JSONPARSER_HPP
+#define JSONPARSER_HPP
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Document.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief The JsonParser class is a two-stage JSON parser producing a Document.
+ *
+ * Stage 1 classifies the input 64 bytes at a time with SIMD compares (AVX2 or SSE2, with a scalar
+ * fallback) and records the offset of every structural character, string opening quote and scalar
+ * start that lies outside a string. Stage 2 walks that index and builds the document tape, so it
+ * never has to look at whitespace or string contents byte by byte.
+ */
+class JsonParser
+{
+public:
+    /**
+     * @brief Parses a JSON text into a Document.
+     * Every key and string is copied into the document's arena, so the input may be discarded.
+     * @param json The JSON text.
+     * @return The parsed document.
+     * @throws std::runtime_error if the text is not valid JSON.
+     */
+    static Document parse(std::string_view json)
+    {
+        return build(json, false);
+    }
+
+    /**
+     * @brief Parses a JSON text into a Document whose keys, strings and numbers point into the input.
+     * Only strings containing escapes are decoded into the arena. The input must outlive the
+     * document; Document::retainSource() can tie the two together.
+     * @param json The JSON text.
+     * @return The parsed document.
+     * @throws std::runtime_error if the text is not valid JSON.
+     */
+    static Document parseInPlace(std::string_view json)
+    {
+        return build(json, true);
+    }
+
+    /**
+     * @brief Stage 1: returns the offsets of all structural characters outside of strings.
+     *
+     * Structural characters are the brackets, braces, colons and commas, the opening quote of every
+     * string and the first byte of every number or literal.
+     * @param json The JSON text.
+     * @return The ascending list of structural offsets.
+     * @throws std::runtime_error if the input is too large or a string is not terminated.
+     */
+    static std::vector<uint32_t> findStructuralIndices(std::string_view json)
+    {
+        if (json.size() >= UINT32_MAX)
+        {
+            throw std::runtime_error("JSON input exceeds 4 GiB");
+        }
+        std::vector<uint32_t> indices;
+        indices.reserve(json.size() / 8 + 16);
+
+        uint64_t previousInString = 0;   // All ones if the previous block ended inside a string
+        uint64_t previousScalar = 0;     // 1 if the previous block ended inside a scalar token
+        bool escapeNext = false;         // The previous block ended with an unescaped backslash
+
+        size_t offset = 0;
+        char lastBlock[64];
+        while (offset < json.size())
+        {
+            const char *block = json.data() + offset;
+            if (json.size() - offset < 64)
+            {
+                std::memset(lastBlock, ' ', sizeof(lastBlock));
+                std::memcpy(lastBlock, block, json.size() - offset);
+                block = lastBlock;
+            }
+            BlockMasks masks = classify(block);
+
+            uint64_t escaped = findEscaped(masks.backslash, escapeNext);
+            uint64_t quotes = masks.quote & ~escaped;
+            uint64_t inString = prefixXor(quotes) ^ previousInString;
+            previousInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+            uint64_t openingQuotes = quotes & inString;
+            uint64_t structural = masks.structural & ~inString;
+            uint64_t scalar = ~(masks.structural | masks.whitespace | quotes | inString);
+            uint64_t scalarStarts = scalar & ~((scalar << 1) | previousScalar);
+            previousScalar = scalar >> 63;
+
+            uint64_t bits = structural | openingQuotes | scalarStarts;
+            while (bits)
+            {
+                size_t position = offset + static_cast<size_t>(countTrailingZeros(bits));
+                if (position < json.size())
+                {
+                    indices.push_back(static_cast<uint32_t>(position));
+                }
+                bits &= bits - 1;
+            }
+            offset += 64;
+        }
+        if (previousInString)
+        {
+            throw std::runtime_error("Unterminated JSON string");
+        }
+        return indices;
+    }
+
+    /**
+     * @brief Decodes a JSON string body (without the quotes), resolving escapes and \\u sequences.
+     * @param body The raw characters between the quotes.
+     * @return The decoded UTF-8 string.
+     * @throws std::runtime_error on an invalid escape sequence.
+     */
+    static std::string unescape(std::string_view body)
+    {
+        std::string result;
+        result.reserve(body.size());
+        size_t i = 0;
+        while (i < body.size())
+        {
+            size_t backslash = body.find('\\', i);
+            if (backslash == std::string_view::npos)
+            {
+                result.append(body.data() + i, body.size() - i);
+                break;
+            }
+            result.append(body.data() + i, backslash - i);
+            if (backslash + 1 >= body.size())
+            {
+                throw std::runtime_error("Invalid JSON escape sequence");
+            }
+            char code = body[backslash + 1];
+            i = backslash + 2;
+            switch (code)
+            {
+            case '"': result.push_back('"'); break;
+            case '\\': result.push_back('\\'); break;
+            case '/': result.push_back('/'); break;
+            case 'b': result.push_back('\b'); break;
+            case 'f': result.push_back('\f'); break;
+            case 'n': result.push_back('\n'); break;
+            case 'r': result.push_back('\r'); break;
+            case 't': result.push_back('\t'); break;
+            case 'u':
+            {
+                uint32_t codePoint = parseHex4(body, i);
+                i += 4;
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF && i + 6 <= body.size() && body[i] == '\\' && body[i + 1] == 'u')
+                {
+                    uint32_t low = parseHex4(body, i + 2);
+                    if (low >= 0xDC00 && low <= 0xDFFF)
+                    {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        i += 6;
+                    }
+                }
+                appendUtf8(result, codePoint);
+                break;
+            }
+            default:
+                throw std::runtime_error("Invalid JSON escape sequence");
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Validates and converts a JSON number literal.
+     * @param literal The number text.
+     * @return The numeric value.
+     * @throws std::runtime_error if the literal is not a valid JSON number.
+     */
+    static double parseNumber(std::string_view literal)
+    {
+        size_t i = 0;
+        auto digits = [&]()
+        {
+            size_t start = i;
+            while (i < literal.size() && literal[i] >= '0' && literal[i] <= '9')
+            {
+                ++i;
+            }
+            return i - start;
+        };
+        if (i < literal.size() && literal[i] == '-')
+        {
+            ++i;
+        }
+        size_t integerStart = i;
+        size_t integerDigits = digits();
+        bool valid = integerDigits > 0 && !(integerDigits > 1 && literal[integerStart] == '0');
+        if (valid && i < literal.size() && literal[i] == '.')
+        {
+            ++i;
+            valid = digits() > 0;
+        }
+        if (valid && i < literal.size() && (literal[i] == 'e' || literal[i] == 'E'))
+        {
+            ++i;
+            if (i < literal.size() && (literal[i] == '+' || literal[i] == '-'))
+            {
+                ++i;
+            }
+            valid = digits() > 0;
+        }
+        double value = 0.0;
+        if (!valid || i != literal.size() ||
+            std::from_chars(literal.data(), literal.data() + literal.size(), value).ec == std::errc::invalid_argument)
+        {
+            throw std::runtime_error("Invalid JSON number: " + std::string(literal));
+        }
+        return value;
+    }
+
+    /**
+     * @brief Returns the raw body of the string whose opening quote is at the given offset.
+     * @param json The JSON text, already validated by findStructuralIndices.
+     * @param openingQuote The offset of the opening quote.
+     * @return The characters between the quotes, escapes not yet decoded.
+     */
+    static std::string_view stringBodyAt(std::string_view json, size_t openingQuote)
+    {
+        size_t end = openingQuote + 1;
+        while (true)
+        {
+            end = json.find('"', end);
+            size_t backslashes = 0;
+            while (json[end - 1 - backslashes] == '\\')
+            {
+                ++backslashes;
+            }
+            if (backslashes % 2 == 0)
+            {
+                break;
+            }
+            ++end;
+        }
+        return json.substr(openingQuote + 1, end - openingQuote - 1);
+    }
+
+    /**
+     * @brief Returns the number or literal token starting at the given offset.
+     * The token runs until the next whitespace or structural character.
+     */
+    static std::string_view scalarAt(std::string_view json, size_t offset)
+    {
+        size_t end = offset;
+        while (end < json.size())
+        {
+            char c = json[end];
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',' || c == ':' ||
+                c == '{' || c == '}' || c == '[' || c == ']' || c == '"')
+            {
+                break;
+            }
+            ++end;
+        }
+        return json.substr(offset, end - offset);
+    }
+
+private:
+    struct BlockMasks
+    {
+        uint64_t quote = 0;
+        uint64_t backslash = 0;
+        uint64_t structural = 0; // { } [ ] : ,
+        uint64_t whitespace = 0; // space, tab, newline, carriage return
+    };
+
+#if defined(__AVX2__)
+    static BlockMasks classify(const char *block)
+    {
+        BlockMasks masks;
+        for (int half = 0; half < 2; ++half)
+        {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + half * 32));
+            auto eq = [&](char c)
+            {
+                return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(c)))));
+            };
+            int shift = half * 32;
+            masks.quote |= eq('"') << shift;
+            masks.backslash |= eq('\\') << shift;
+            masks.structural |= (eq('{') | eq('}') | eq('[') | eq(']') | eq(':') | eq(',')) << shift;
+            masks.whitespace |= (eq(' ') | eq('\t') | eq('\n') | eq('\r')) << shift;
+        }
+        return masks;
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    static BlockMasks classify(const char *block)
+    {
+        BlockMasks masks;
+        for (int quarter = 0; quarter < 4; ++quarter)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + quarter * 16));
+            auto eq = [&](char c)
+            {
+                return static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(c)))));
+            };
+            int shift = quarter * 16;
+            masks.quote |= eq('"') << shift;
+            masks.backslash |= eq('\\') << shift;
+            masks.structural |= (eq('{') | eq('}') | eq('[') | eq(']') | eq(':') | eq(',')) << shift;
+            masks.whitespace |= (eq(' ') | eq('\t') | eq('\n') | eq('\r')) << shift;
+        }
+        return masks;
+    }
+#else
+    static BlockMasks classify(const char *block)
+    {
+        BlockMasks masks;
+        for (int i = 0; i < 64; ++i)
+        {
+            uint64_t bit = uint64_t(1) << i;
+            switch (block[i])
+            {
+            case '"': masks.quote |= bit; break;
+            case '\\': masks.backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',': masks.structural |= bit; break;
+            case ' ': case '\t': case '\n': case '\r': masks.whitespace |= bit; break;
+            default: break;
+            }
+        }
+        return masks;
+    }
+#endif
+
+    static Document build(std::string_view json, bool inPlace)
+    {
+        std::vector<uint32_t> structurals = findStructuralIndices(json);
+        Document document;
+        document.reserve(structurals.size() / 2 + 1);
+        TapeBuilder builder(json, structurals, document, inPlace);
+        builder.build();
+        return document;
+    }
+
+    // Returns the characters escaped by a preceding unescaped backslash. Blocks without backslashes
+    // (the common case) cost a single branch; others are resolved bit by bit.
+    static uint64_t findEscaped(uint64_t backslash, bool &escapeNext)
+    {
+        if (!backslash && !escapeNext)
+        {
+            return 0;
+        }
+        uint64_t escaped = 0;
+        for (int i = 0; i < 64; ++i)
+        {
+            uint64_t bit = uint64_t(1) << i;
+            if (escapeNext)
+            {
+                escaped |= bit;
+                escapeNext = false;
+            }
+            else if (backslash & bit)
+            {
+                escapeNext = true;
+            }
+        }
+        return escaped;
+    }
+
+    // Inclusive prefix XOR: bit i is set when an odd number of quotes occur at or before i.
+    static uint64_t prefixXor(uint64_t bits)
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    static int countTrailingZeros(uint64_t bits)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(bits);
+#else
+        int count = 0;
+        while (!(bits & 1))
+        {
+            bits >>= 1;
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    static uint32_t parseHex4(std::string_view text, size_t position)
+    {
+        if (position + 4 > text.size())
+        {
+            throw std::runtime_error("Invalid JSON unicode escape");
+        }
+        uint32_t value = 0;
+        for (size_t i = position; i < position + 4; ++i)
+        {
+            char c = text[i];
+            value <<= 4;
+            if (c >= '0' && c <= '9')
+                value |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f')
+                value |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                value |= static_cast<uint32_t>(c - 'A' + 10);
+            else
+                throw std::runtime_error("Invalid JSON unicode escape");
+        }
+        return value;
+    }
+
+    static void appendUtf8(std::string &out, uint32_t codePoint)
+    {
+        if (codePoint < 0x80)
+        {
+            out.push_back(static_cast<char>(codePoint));
+        }
+        else if (codePoint < 0x800)
+        {
+            out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else if (codePoint < 0x10000)
+        {
+            out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+
+    /**
+     * @brief Stage 2: walks the structural index and appends nodes to the document tape.
+     */
+    class TapeBuilder
+    {
+    public:
+        TapeBuilder(std::string_view json, const std::vector<uint32_t> &structurals, Document &document, bool inPlace)
+            : json(json), structurals(structurals), document(document), inPlace(inPlace) {}
+
+        void build()
+        {
+            if (structurals.empty())
+            {
+                throw std::runtime_error("Empty JSON document");
+            }
+            parseValue({});
+            while (!containers.empty())
+            {
+                bool isObject = containers.back() == '{';
+                size_t offset = next();
+                char c = json[offset];
+                if (c == ',')
+                {
+                    if (isObject)
+                    {
+                        parseMember();
+                    }
+                    else
+                    {
+                        parseValue({});
+                    }
+                }
+                else if (c == (isObject ? '}' : ']'))
+                {
+                    containers.pop_back();
+                    document.closeContainer();
+                }
+                else
+                {
+                    fail("expected ',' or closing bracket", offset);
+                }
+            }
+            if (position != structurals.size())
+            {
+                fail("unexpected content after document", structurals[position]);
+            }
+        }
+
+    private:
+        std::string_view json;
+        const std::vector<uint32_t> &structurals;
+        Document &document;
+        bool inPlace;                 // Reference the input instead of copying unescaped text
+        size_t position = 0;          // Next entry of the structural index to consume
+        std::vector<char> containers; // Open '{' and '[' from outermost to innermost
+
+        size_t next()
+        {
+            if (position >= structurals.size())
+            {
+                throw std::runtime_error("Unexpected end of JSON input");
+            }
+            return structurals[position++];
+        }
+
+        bool peekIs(char c) const
+        {
+            return position < structurals.size() && json[structurals[position]] == c;
+        }
+
+        [[noreturn]] void fail(const std::string &message, size_t offset) const
+        {
+            throw std::runtime_error("Invalid JSON at offset " + std::to_string(offset) + ": " + message);
+        }
+
+        void parseMember()
+        {
+            size_t offset = next();
+            if (json[offset] != '"')
+            {
+                fail("expected object key", offset);
+            }
+            std::string_view key = readString(offset);
+            offset = next();
+            if (json[offset] != ':')
+            {
+                fail("expected ':'", offset);
+            }
+            parseValue(key);
+        }
+
+        // Parses one value; containers are opened here and closed by the loop in build().
+        void parseValue(std::string_view key)
+        {
+            size_t offset = next();
+            char c = json[offset];
+            if (c == '{' || c == '[')
+            {
+                document.openContainer(c == '{' ? Document::Type::Object : Document::Type::Array, key);
+                char close = c == '{' ? '}' : ']';
+                if (peekIs(close))
+                {
+                    ++position;
+                    document.closeContainer();
+                    return;
+                }
+                containers.push_back(c);
+                if (c == '{')
+                {
+                    parseMember();
+                }
+                else
+                {
+                    parseValue({});
+                }
+            }
+            else if (c == '"')
+            {
+                document.addScalar(Document::Type::String, key, readString(offset));
+            }
+            else if (c == '}' || c == ']' || c == ':' || c == ',')
+            {
+                fail("expected value", offset);
+            }
+            else
+            {
+                std::string_view literal = scalarAt(json, offset);
+                if (literal == "true")
+                    document.addScalar(Document::Type::Boolean, key, "true", 1.0);
+                else if (literal == "false")
+                    document.addScalar(Document::Type::Boolean, key, "false", 0.0);
+                else if (literal == "null")
+                    document.addScalar(Document::Type::Null, key, "null");
+                else
+                    document.addScalar(Document::Type::Number, key, inPlace ? literal : document.store(literal), parseNumber(literal));
+            }
+        }
+
+        std::string_view readString(size_t openingQuote)
+        {
+            std::string_view body = stringBodyAt(json, openingQuote);
+            if (body.find('\\') != std::string_view::npos)
+            {
+                return document.store(unescape(body));
+            }
+            return inPlace ? body : document.store(body);
+        }
+    };
+};
+
+#endif // JSONPARSER_HPP
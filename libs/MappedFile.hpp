@@ -0,0 +1,218 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief The MappedFile class maps a file read-only into memory for the lifetime of the object.
+ *
+ * The contents are exposed as a std::string_view over the page cache, so parsers can work on the
+ * file without copying it into a std::string first. The mapping is released on destruction; views
+ * obtained from view() must not outlive the MappedFile. Empty files yield an empty view.
+ *
+ * A mapping shows later writes to the file, and reading past a truncation raises SIGBUS. Results
+ * that must outlive changes to the file should come from copyOf(), which reads the file into memory
+ * owned by the object instead.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    /**
+     * @brief Maps the file at the given path.
+     * @param path The path of the file to map.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string &path)
+    {
+#ifdef _WIN32
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error("Error opening file: " + path);
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize))
+        {
+            release();
+            throw std::runtime_error("Error reading file size: " + path);
+        }
+        length = static_cast<size_t>(fileSize.QuadPart);
+        if (length > 0)
+        {
+            mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mappingHandle)
+            {
+                release();
+                throw std::runtime_error("Error mapping file: " + path);
+            }
+            address = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+            if (!address)
+            {
+                release();
+                throw std::runtime_error("Error mapping file: " + path);
+            }
+        }
+#else
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+        {
+            throw std::runtime_error("Error opening file: " + path);
+        }
+        struct stat status;
+        if (::fstat(descriptor, &status) != 0)
+        {
+            ::close(descriptor);
+            throw std::runtime_error("Error reading file size: " + path);
+        }
+        length = static_cast<size_t>(status.st_size);
+        if (length > 0)
+        {
+            address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (address == MAP_FAILED)
+            {
+                address = nullptr;
+                length = 0;
+                ::close(descriptor);
+                throw std::runtime_error("Error mapping file: " + path);
+            }
+            ::madvise(address, length, MADV_SEQUENTIAL); // Parsers scan front to back; read ahead aggressively
+        }
+        ::close(descriptor); // The mapping keeps its own reference to the file
+#endif
+    }
+
+    /**
+     * @brief Reads the file at the given path into memory owned by the returned object, so its
+     * view is unaffected by later writes to or truncation of the file.
+     * @param path The path of the file to read.
+     * @throws std::runtime_error if the file cannot be opened or read.
+     */
+    static MappedFile copyOf(const std::string &path)
+    {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in)
+        {
+            throw std::runtime_error("Error opening file: " + path);
+        }
+        std::streamoff size = in.tellg();
+        in.seekg(0);
+        if (size < 0 || !in)
+        {
+            throw std::runtime_error("Error reading file size: " + path);
+        }
+        MappedFile file;
+        if (size > 0)
+        {
+            file.copy.reset(new char[static_cast<size_t>(size)]);
+            in.read(file.copy.get(), size);
+            if (in.bad())
+            {
+                throw std::runtime_error("Error reading file: " + path);
+            }
+            file.address = file.copy.get();
+            file.length = static_cast<size_t>(in.gcount()); // Shorter if truncated while reading
+        }
+        return file;
+    }
+
+    ~MappedFile()
+    {
+        release();
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept
+    {
+        takeFrom(other);
+    }
+
+    MappedFile &operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Returns the mapped contents.
+     */
+    std::string_view view() const
+    {
+        return address ? std::string_view(static_cast<const char *>(address), length) : std::string_view();
+    }
+
+    const char *data() const { return static_cast<const char *>(address); }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+private:
+    void *address = nullptr; // Start of the mapping, null for empty files
+    size_t length = 0;       // Size of the mapping in bytes
+    std::unique_ptr<char[]> copy; // The contents read by copyOf(), which address points into
+#ifdef _WIN32
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = nullptr;
+#endif
+
+    void release()
+    {
+#ifdef _WIN32
+        if (address && !copy)
+            UnmapViewOfFile(address);
+        if (mappingHandle)
+            CloseHandle(mappingHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE)
+            CloseHandle(fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (address && !copy)
+            ::munmap(address, length);
+#endif
+        copy.reset();
+        address = nullptr;
+        length = 0;
+    }
+
+    void takeFrom(MappedFile &other)
+    {
+        address = other.address;
+        length = other.length;
+        copy = std::move(other.copy);
+        other.address = nullptr;
+        other.length = 0;
+#ifdef _WIN32
+        fileHandle = other.fileHandle;
+        mappingHandle = other.mappingHandle;
+        other.fileHandle = INVALID_HANDLE_VALUE;
+        other.mappingHandle = nullptr;
+#endif
+    }
+};
+
+#endif // MAPPEDFILE_HPP
@@ -5,6 +5,8 @@
 #include <stdexcept>
 #include <numeric>
 #include <cmath>
+#include <cstddef>
+#include <type_traits>
 #include "Logger.hpp" // Assuming Logger.hpp is in the same directory
 
 class MathOperations
@@ -12,9 +14,53 @@ class MathOperations
 private:
     static Logger logger;
 
+    // Picks the default accumulator for sum/dot kernels: floating types accumulate in their own
+    // precision, integer types widen to 64 bits so large sums do not overflow.
+    template <typename T, typename Acc>
+    struct AccumulatorSelector
+    {
+        using type = Acc;
+    };
+
+    template <typename T>
+    struct AccumulatorSelector<T, void>
+    {
+        using type = std::conditional_t<std::is_floating_point_v<T>, T,
+                                        std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>>;
+    };
+
+    // Picks the default type for statistics (mean, variance, ...): integer data is promoted to double.
+    template <typename T, typename Acc>
+    struct StatisticSelector
+    {
+        using type = Acc;
+    };
+
+    template <typename T>
+    struct StatisticSelector<T, void>
+    {
+        using type = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+    };
+
+public:
+    /**
+     * Accumulator type used by sum and dot product for element type T.
+     * Pass an explicit Acc (e.g. double for float storage) to trade throughput for precision.
+     */
+    template <typename T, typename Acc = void>
+    using Accumulator = typename AccumulatorSelector<T, Acc>::type;
+
+    /**
+     * Result type used by the statistics functions for element type T.
+     */
+    template <typename T, typename Acc = void>
+    using Statistic = typename StatisticSelector<T, Acc>::type;
+
+private:
     // Helper function to validate matrix dimensions for addition and subtraction
-    static void validateMatrixDimensions(const std::vector<std::vector<double>> &matrixA,
-                                         const std::vector<std::vector<double>> &matrixB,
+    template <typename T>
+    static void validateMatrixDimensions(const std::vector<std::vector<T>> &matrixA,
+                                         const std::vector<std::vector<T>> &matrixB,
                                          const std::string &operation)
     {
         if (matrixA.size() == 0 || matrixA.size() != matrixB.size() || matrixA[0].size() != matrixB[0].size())
@@ -24,6 +70,67 @@ private:
         }
     }
 
+    // Sums n elements into Acc using four independent partial sums. The partial sums break the
+    // loop-carried dependency so the compiler can keep several SIMD lanes busy without -ffast-math.
+    template <typename Acc, typename T>
+    static Acc sumKernel(const T *data, size_t n)
+    {
+        Acc lanes[4] = {Acc(0), Acc(0), Acc(0), Acc(0)};
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            lanes[0] += static_cast<Acc>(data[i]);
+            lanes[1] += static_cast<Acc>(data[i + 1]);
+            lanes[2] += static_cast<Acc>(data[i + 2]);
+            lanes[3] += static_cast<Acc>(data[i + 3]);
+        }
+        for (; i < n; ++i)
+        {
+            lanes[0] += static_cast<Acc>(data[i]);
+        }
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+
+    // Dot product of n elements accumulated in Acc, unrolled the same way as sumKernel.
+    template <typename Acc, typename T>
+    static Acc dotKernel(const T *dataA, const T *dataB, size_t n)
+    {
+        Acc lanes[4] = {Acc(0), Acc(0), Acc(0), Acc(0)};
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            lanes[0] += static_cast<Acc>(dataA[i]) * static_cast<Acc>(dataB[i]);
+            lanes[1] += static_cast<Acc>(dataA[i + 1]) * static_cast<Acc>(dataB[i + 1]);
+            lanes[2] += static_cast<Acc>(dataA[i + 2]) * static_cast<Acc>(dataB[i + 2]);
+            lanes[3] += static_cast<Acc>(dataA[i + 3]) * static_cast<Acc>(dataB[i + 3]);
+        }
+        for (; i < n; ++i)
+        {
+            lanes[0] += static_cast<Acc>(dataA[i]) * static_cast<Acc>(dataB[i]);
+        }
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+
+    // Sum of (a[i] - meanA) * (b[i] - meanB) accumulated in Acc; with a == b this is the variance numerator.
+    template <typename Acc, typename T>
+    static Acc centeredProductKernel(const T *dataA, Acc meanA, const T *dataB, Acc meanB, size_t n)
+    {
+        Acc lanes[4] = {Acc(0), Acc(0), Acc(0), Acc(0)};
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            lanes[0] += (static_cast<Acc>(dataA[i]) - meanA) * (static_cast<Acc>(dataB[i]) - meanB);
+            lanes[1] += (static_cast<Acc>(dataA[i + 1]) - meanA) * (static_cast<Acc>(dataB[i + 1]) - meanB);
+            lanes[2] += (static_cast<Acc>(dataA[i + 2]) - meanA) * (static_cast<Acc>(dataB[i + 2]) - meanB);
+            lanes[3] += (static_cast<Acc>(dataA[i + 3]) - meanA) * (static_cast<Acc>(dataB[i + 3]) - meanB);
+        }
+        for (; i < n; ++i)
+        {
+            lanes[0] += (static_cast<Acc>(dataA[i]) - meanA) * (static_cast<Acc>(dataB[i]) - meanB);
+        }
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+
 public:
     MathOperations()
     {
@@ -33,16 +140,18 @@ public:
     /**
      * Adds two matrices.
      *
+     * @tparam T The element type (float, double or an integer type).
      * @param matrixA The first matrix.
      * @param matrixB The second matrix.
      * @return The result of matrix addition.
      * @throws std::invalid_argument if matrices have incompatible dimensions.
      */
-    static std::vector<std::vector<double>> addMatrices(const std::vector<std::vector<double>> &matrixA,
-                                                        const std::vector<std::vector<double>> &matrixB)
+    template <typename T = double>
+    static std::vector<std::vector<T>> addMatrices(const std::vector<std::vector<T>> &matrixA,
+                                                   const std::vector<std::vector<T>> &matrixB)
     {
         validateMatrixDimensions(matrixA, matrixB, "addition");
-        std::vector<std::vector<double>> result(matrixA.size(), std::vector<double>(matrixA[0].size(), 0));
+        std::vector<std::vector<T>> result(matrixA.size(), std::vector<T>(matrixA[0].size(), 0));
         for (size_t i = 0; i < matrixA.size(); ++i)
         {
             for (size_t j = 0; j < matrixA[i].size(); ++j)
@@ -57,16 +166,18 @@ public:
     /**
      * Subtracts two matrices.
      *
+     * @tparam T The element type (float, double or an integer type).
      * @param matrixA The first matrix.
      * @param matrixB The second matrix.
      * @return The result of matrix subtraction.
      * @throws std::invalid_argument if matrices have incompatible dimensions.
      */
-    static std::vector<std::vector<double>> subtractMatrices(const std::vector<std::vector<double>> &matrixA,
-                                                             const std::vector<std::vector<double>> &matrixB)
+    template <typename T = double>
+    static std::vector<std::vector<T>> subtractMatrices(const std::vector<std::vector<T>> &matrixA,
+                                                        const std::vector<std::vector<T>> &matrixB)
     {
         validateMatrixDimensions(matrixA, matrixB, "subtraction");
-        std::vector<std::vector<double>> result(matrixA.size(), std::vector<double>(matrixA[0].size(), 0));
+        std::vector<std::vector<T>> result(matrixA.size(), std::vector<T>(matrixA[0].size(), 0));
         for (size_t i = 0; i < matrixA.size(); ++i)
         {
             for (size_t j = 0; j < matrixA[i].size(); ++j)
@@ -78,22 +189,46 @@ public:
         return result;
     }
 
+    /**
+     * Calculates the sum of a vector of numbers.
+     *
+     * @tparam Acc Optional accumulator type, e.g. sum<double>(floatData) stores float but accumulates in double.
+     * @param data The input data vector.
+     * @return The sum of all elements.
+     * @throws std::invalid_argument if the data vector is empty.
+     */
+    template <typename Acc = void, typename T = double>
+    static Accumulator<T, Acc> sum(const std::vector<T> &data)
+    {
+        if (data.empty())
+        {
+            logger.log("Sum calculation failed: Empty data vector");
+            throw std::invalid_argument("Data vector is empty");
+        }
+        Accumulator<T, Acc> sum = sumKernel<Accumulator<T, Acc>>(data.data(), data.size());
+        logger.log("Sum calculation successful");
+        return sum;
+    }
+
     /**
      * Calculates the mean of a vector of numbers.
      *
+     * @tparam Acc Optional accumulator/result type, e.g. mean<double>(floatData).
      * @param data The input data vector.
      * @return The mean value.
      * @throws std::invalid_argument if the data vector is empty.
      */
-    static double mean(const std::vector<double> &data)
+    template <typename Acc = void, typename T = double>
+    static Statistic<T, Acc> mean(const std::vector<T> &data)
     {
         if (data.empty())
         {
             logger.log("Mean calculation failed: Empty data vector");
             throw std::invalid_argument("Data vector is empty");
         }
-        double sum = std::accumulate(data.begin(), data.end(), 0.0);
-        double mean = sum / data.size();
+        using Result = Statistic<T, Acc>;
+        Result sum = sumKernel<Result>(data.data(), data.size());
+        Result mean = sum / static_cast<Result>(data.size());
         logger.log("Mean calculation successful");
         return mean;
     }
@@ -101,24 +236,23 @@ public:
 /**
  * Calculates the variance of a vector of numbers.
  *
+ * @tparam Acc Optional accumulator/result type, e.g. variance<double>(floatData).
  * @param data The input data vector.
  * @return The variance value.
  * @throws std::invalid_argument if the data vector is empty.
  */
-static double variance(const std::vector<double> &data)
+template <typename Acc = void, typename T = double>
+static Statistic<T, Acc> variance(const std::vector<T> &data)
 {
     if (data.empty())
     {
         logger.log("Variance calculation failed: Empty data vector");
         throw std::invalid_argument("Data vector is empty");
     }
-    double meanValue = mean(data);
-    double sum = 0.0;
-    for (const auto &elem : data)
-    {
-        sum += (elem - meanValue) * (elem - meanValue);
-    }
-    double variance = sum / data.size();
+    using Result = Statistic<T, Acc>;
+    Result meanValue = mean<Result>(data);
+    Result sum = centeredProductKernel<Result>(data.data(), meanValue, data.data(), meanValue, data.size());
+    Result variance = sum / static_cast<Result>(data.size());
     logger.log("Variance calculation successful");
     return variance;
 }
@@ -126,19 +260,22 @@ static double variance(const std::vector<double> &data)
 /**
  * Calculates the standard deviation of a vector of numbers.
  *
+ * @tparam Acc Optional accumulator/result type, e.g. standardDeviation<double>(floatData).
  * @param data The input data vector.
  * @return The standard deviation value.
  * @throws std::invalid_argument if the data vector is empty.
  */
-static double standardDeviation(const std::vector<double> &data)
+template <typename Acc = void, typename T = double>
+static Statistic<T, Acc> standardDeviation(const std::vector<T> &data)
 {
     if (data.empty())
     {
         logger.log("Standard deviation calculation failed: Empty data vector");
         throw std::invalid_argument("Data vector is empty");
     }
-    double varianceValue = variance(data);
-    double standardDeviation = std::sqrt(varianceValue);
+    using Result = Statistic<T, Acc>;
+    Result varianceValue = variance<Result>(data);
+    Result standardDeviation = std::sqrt(varianceValue);
     logger.log("Standard deviation calculation successful");
     return standardDeviation;
 }
@@ -146,12 +283,14 @@ static double standardDeviation(const std::vector<double> &data)
 /**
  * Calculates the covariance between two vectors of numbers.
  *
+ * @tparam Acc Optional accumulator/result type, e.g. covariance<double>(floatA, floatB).
  * @param dataA The first data vector.
  * @param dataB The second data vector.
  * @return The covariance value.
  * @throws std::invalid_argument if either data vector is empty or they have different sizes.
  */
-static double covariance(const std::vector<double> &dataA, const std::vector<double> &dataB)
+template <typename Acc = void, typename T = double>
+static Statistic<T, Acc> covariance(const std::vector<T> &dataA, const std::vector<T> &dataB)
 {
     if (dataA.empty() || dataB.empty())
     {
@@ -163,14 +302,11 @@ static double covariance(const std::vector<double> &dataA, const std::vector<dou
         logger.log("Covariance calculation failed: Incompatible data vectors");
         throw std::invalid_argument("Data vectors are not of equal size");
     }
-    double meanA = mean(dataA);
-    double meanB = mean(dataB);
-    double sum = 0.0;
-    for (size_t i = 0; i < dataA.size(); ++i)
-    {
-        sum += (dataA[i] - meanA) * (dataB[i] - meanB);
-    }
-    double covariance = sum / dataA.size();
+    using Result = Statistic<T, Acc>;
+    Result meanA = mean<Result>(dataA);
+    Result meanB = mean<Result>(dataB);
+    Result sum = centeredProductKernel<Result>(dataA.data(), meanA, dataB.data(), meanB, dataA.size());
+    Result covariance = sum / static_cast<Result>(dataA.size());
     logger.log("Covariance calculation successful");
     return covariance;
 }
@@ -178,12 +314,14 @@ static double covariance(const std::vector<double> &dataA, const std::vector<dou
 /**
  * Calculates the correlation coefficient between two vectors of numbers.
  *
+ * @tparam Acc Optional accumulator/result type, e.g. correlationCoefficient<double>(floatA, floatB).
  * @param dataA The first data vector.
  * @param dataB The second data vector.
  * @return The correlation coefficient.
  * @throws std::invalid_argument if either data vector is empty or they have different sizes.
  */
-static double correlationCoefficient(const std::vector<double> &dataA, const std::vector<double> &dataB)
+template <typename Acc = void, typename T = double>
+static Statistic<T, Acc> correlationCoefficient(const std::vector<T> &dataA, const std::vector<T> &dataB)
 {
     if (dataA.empty() || dataB.empty())
     {
@@ -195,10 +333,11 @@ static double correlationCoefficient(const std::vector<double> &dataA, const std
         logger.log("Correlation coefficient calculation failed: Incompatible data vectors");
         throw std::invalid_argument("Data vectors are not of equal size");
     }
-    double covarianceValue = covariance(dataA, dataB);
-    double standardDeviationA = standardDeviation(dataA);
-    double standardDeviationB = standardDeviation(dataB);
-    double correlationCoefficient = covarianceValue / (standardDeviationA * standardDeviationB);
+    using Result = Statistic<T, Acc>;
+    Result covarianceValue = covariance<Result>(dataA, dataB);
+    Result standardDeviationA = standardDeviation<Result>(dataA);
+    Result standardDeviationB = standardDeviation<Result>(dataB);
+    Result correlationCoefficient = covarianceValue / (standardDeviationA * standardDeviationB);
     logger.log("Correlation coefficient calculation successful");
     return correlationCoefficient;
 }
@@ -206,12 +345,14 @@ static double correlationCoefficient(const std::vector<double> &dataA, const std
 /**
  * Calculates the dot product of two vectors of numbers.
  *
+ * @tparam Acc Optional accumulator type, e.g. dotProduct<double>(floatA, floatB).
  * @param dataA The first data vector.
  * @param dataB The second data vector.
  * @return The dot product.
  * @throws std::invalid_argument if either data vector is empty or they have different sizes.
  */
-static double dotProduct(const std::vector<double> &dataA, const std::vector<double> &dataB)
+template <typename Acc = void, typename T = double>
+static Accumulator<T, Acc> dotProduct(const std::vector<T> &dataA, const std::vector<T> &dataB)
 {
     if (dataA.empty() || dataB.empty())
     {
@@ -223,11 +364,7 @@ static double dotProduct(const std::vector<double> &dataA, const std::vector<dou
         logger.log("Dot product calculation failed: Incompatible data vectors");
         throw std::invalid_argument("Data vectors are not of equal size");
     }
-    double sum = 0.0;
-    for (size_t i = 0; i < dataA.size(); ++i)
-    {
-        sum += dataA[i] * dataB[i];
-    }
+    Accumulator<T, Acc> sum = dotKernel<Accumulator<T, Acc>>(dataA.data(), dataB.data(), dataA.size());
     logger.log("Dot product calculation successful");
     return sum;
 }
@@ -240,7 +377,8 @@ static double dotProduct(const std::vector<double> &dataA, const std::vector<dou
  * @return The cross product vector (size 3).
  * @throws std::invalid_argument if either data vector is empty or they are not of size 3.
  */
-static std::vector<double> crossProduct(const std::vector<double> &dataA, const std::vector<double> &dataB)
+template <typename T = double>
+static std::vector<T> crossProduct(const std::vector<T> &dataA, const std::vector<T> &dataB)
 {
     if (dataA.empty() || dataB.empty())
     {
@@ -252,7 +390,7 @@ static std::vector<double> crossProduct(const std::vector<double> &dataA, const
         logger.log("Cross product calculation failed: Incompatible data vectors");
         throw std::invalid_argument("Data vectors are not of size 3");
     }
-    std::vector<double> result(3, 0);
+    std::vector<T> result(3, 0);
     result[0] = dataA[1] * dataB[2] - dataA[2] * dataB[1];
     result[1] = dataA[2] * dataB[0] - dataA[0] * dataB[2];
     result[2] = dataA[0] * dataB[1] - dataA[1] * dataB[0];
@@ -267,14 +405,15 @@ static std::vector<double> crossProduct(const std::vector<double> &dataA, const
  * @return The determinant value.
  * @throws std::invalid_argument if the matrix is not of size 2x2.
  */
-static double determinant(const std::vector<std::vector<double>> &matrix)
+template <typename T = double>
+static T determinant(const std::vector<std::vector<T>> &matrix)
 {
     if (matrix.size() != 2 || matrix[0].size() != 2)
     {
         logger.log("Determinant calculation failed: Incompatible matrix dimensions");
         throw std::invalid_argument("Matrix is not of size 2x2");
     }
-    double determinant = matrix[0][0] * matrix[1][1] - matrix[0][1] * matrix[1][0];
+    T determinant = matrix[0][0] * matrix[1][1] - matrix[0][1] * matrix[1][0];
     logger.log("Determinant calculation successful");
     return determinant;
 }
@@ -282,24 +421,26 @@ static double determinant(const std::vector<std::vector<double>> &matrix)
 /**
  * Calculates the inverse of a 2x2 matrix.
  *
- * @param matrix The 2x2 matrix.
+ * @param matrix The 2x2 matrix (float or double elements).
  * @return The inverse matrix.
  * @throws std::invalid_argument if the matrix is not of size 2x2 or has a determinant of zero.
  */
-static std::vector<std::vector<double>> inverse(const std::vector<std::vector<double>> &matrix)
+template <typename T = double>
+static std::vector<std::vector<T>> inverse(const std::vector<std::vector<T>> &matrix)
 {
+    static_assert(std::is_floating_point_v<T>, "Matrix inverse requires a floating point element type");
     if (matrix.size() != 2 || matrix[0].size() != 2)
     {
         logger.log("Inverse calculation failed: Incompatible matrix dimensions");
         throw std::invalid_argument("Matrix is not of size 2x2");
     }
-    double det = determinant(matrix);
+    T det = determinant(matrix);
     if (det == 0)
     {
         logger.log("Inverse calculation failed: Determinant is zero");
         throw std::invalid_argument("Determinant is zero");
     }
-    std::vector<std::vector<double>> result(2, std::vector<double>(2, 0));
+    std::vector<std::vector<T>> result(2, std::vector<T>(2, 0));
     result[0][0] = matrix[1][1] / det;
     result[0][1] = -matrix[0][1] / det;
     result[1][0] = -matrix[1][0] / det;
@@ -315,14 +456,15 @@ static std::vector<std::vector<double>> inverse(const std::vector<std::vector<do
  * @return The transpose matrix.
  * @throws std::invalid_argument if the matrix is empty.
  */
-static std::vector<std::vector<double>> transpose(const std::vector<std::vector<double>> &matrix)
+template <typename T = double>
+static std::vector<std::vector<T>> transpose(const std::vector<std::vector<T>> &matrix)
 {
     if (matrix.size() == 0)
     {
         logger.log("Transpose calculation failed: Empty matrix");
         throw std::invalid_argument("Matrix is empty");
     }
-    std::vector<std::vector<double>> result(matrix[0].size(), std::vector<double>(matrix.size(), 0));
+    std::vector<std::vector<T>> result(matrix[0].size(), std::vector<T>(matrix.size(), 0));
     for (size_t i = 0; i < matrix.size(); ++i)
     {
         for (size_t j = 0; j < matrix[i].size(); ++j)
@@ -337,11 +479,13 @@ static std::vector<std::vector<double>> transpose(const std::vector<std::vector<
 /**
  * Calculates the trace of a square matrix.
  *
+ * @tparam Acc Optional accumulator type, e.g. trace<double>(floatMatrix).
  * @param matrix The square matrix.
  * @return The trace value.
  * @throws std::invalid_argument if the matrix is empty or not square.
  */
-static double trace(const std::vector<std::vector<double>> &matrix)
+template <typename Acc = void, typename T = double>
+static Accumulator<T, Acc> trace(const std::vector<std::vector<T>> &matrix)
 {
     if (matrix.size() == 0)
     {
@@ -353,10 +497,10 @@ static double trace(const std::vector<std::vector<double>> &matrix)
         logger.log("Trace calculation failed: Incompatible matrix dimensions");
         throw std::invalid_argument("Matrix is not square");
     }
-    double trace = 0.0;
+    Accumulator<T, Acc> trace = 0;
     for (size_t i = 0; i < matrix.size(); ++i)
     {
-        trace += matrix[i][i];
+        trace += static_cast<Accumulator<T, Acc>>(matrix[i][i]);
     }
     logger.log("Trace calculation successful");
     return trace;
@@ -364,25 +508,28 @@ static double trace(const std::vector<std::vector<double>> &matrix)
 
 /**
  * Calculates the rank of a matrix.
+ * Elimination runs in the element type for floating matrices and in double for integer matrices.
  *
  * @param matrix The input matrix.
  * @return The rank of the matrix.
  * @throws std::invalid_argument if the matrix is empty.
  */
-static size_t rank(const std::vector<std::vector<double>> &matrix)
+template <typename T = double>
+static size_t rank(const std::vector<std::vector<T>> &matrix)
 {
     if (matrix.size() == 0)
     {
         logger.log("Rank calculation failed: Empty matrix");
         throw std::invalid_argument("Matrix is empty");
     }
+    using Work = Statistic<T>;
     size_t rank = 0;
-    std::vector<std::vector<double>> temp(matrix.size(), std::vector<double>(matrix[0].size(), 0));
+    std::vector<std::vector<Work>> temp(matrix.size(), std::vector<Work>(matrix[0].size(), 0));
     for (size_t i = 0; i < matrix.size(); ++i)
     {
         for (size_t j = 0; j < matrix[i].size(); ++j)
         {
-            temp[i][j] = matrix[i][j];
+            temp[i][j] = static_cast<Work>(matrix[i][j]);
         }
     }
     for (size_t i = 0; i < temp[0].size(); ++i)
@@ -392,7 +539,7 @@ static size_t rank(const std::vector<std::vector<double>> &matrix)
             ++rank;
             for (size_t j = 1; j < temp.size(); ++j)
             {
-                double ratio = temp[j][i] / temp[0][i];
+                Work ratio = temp[j][i] / temp[0][i];
                 for (size_t k = 0; k < temp[0].size(); ++k)
                 {
                     temp[j][k] -= ratio * temp[0][k];
@@ -426,4 +573,3 @@ static size_t rank(const std::vector<std::vector<double>> &matrix)
 Logger MathOperations::logger = Logger("libs/MathOperations.log");
 
 #endif // MATHOPERATIONS_HPP
-
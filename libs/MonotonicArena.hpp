@@ -0,0 +1,145 @@
+#ifndef MONOTONICARENA_HPP
+#define MONOTONICARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief The MonotonicArena class hands out memory from a few large blocks and frees it all at once.
+ *
+ * Allocation is a pointer bump; individual allocations are never released. Blocks grow
+ * geometrically, so building a structure of N objects costs O(log N) heap allocations and one
+ * release. Only trivially destructible objects may be placed in the arena.
+ */
+class MonotonicArena
+{
+public:
+    /**
+     * @brief Creates an empty arena; no memory is allocated until the first request.
+     * @param initialBlockSize The size of the first block in bytes.
+     */
+    explicit MonotonicArena(size_t initialBlockSize = 64 * 1024) : nextBlockSize(initialBlockSize) {}
+
+    MonotonicArena(const MonotonicArena &) = delete;
+    MonotonicArena &operator=(const MonotonicArena &) = delete;
+    MonotonicArena(MonotonicArena &&other) noexcept
+        : blocks(std::move(other.blocks)), cursor(other.cursor), remaining(other.remaining),
+          nextBlockSize(other.nextBlockSize), reserved(other.reserved)
+    {
+        other.forget();
+    }
+
+    MonotonicArena &operator=(MonotonicArena &&other) noexcept
+    {
+        if (this != &other)
+        {
+            blocks = std::move(other.blocks);
+            cursor = other.cursor;
+            remaining = other.remaining;
+            nextBlockSize = other.nextBlockSize;
+            reserved = other.reserved;
+            other.forget();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Returns uninitialized memory.
+     * @param bytes The number of bytes requested.
+     * @param alignment The required alignment, a power of two no larger than alignof(std::max_align_t).
+     * @return A pointer valid until the arena is released or destroyed.
+     */
+    void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+    {
+        size_t padding = (alignment - reinterpret_cast<uintptr_t>(cursor) % alignment) % alignment;
+        if (!cursor || padding + bytes > remaining)
+        {
+            addBlock(bytes);
+            padding = 0;
+        }
+        char *result = cursor + padding;
+        cursor = result + bytes;
+        remaining -= padding + bytes;
+        return result;
+    }
+
+    /**
+     * @brief Allocates an uninitialized array of trivially destructible objects.
+     */
+    template <typename T>
+    T *allocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "MonotonicArena never runs destructors");
+        return static_cast<T *>(allocate(sizeof(T) * (count == 0 ? 1 : count), alignof(T)));
+    }
+
+    /**
+     * @brief Copies text into the arena.
+     * @return A view of the copy, valid for the lifetime of the arena.
+     */
+    std::string_view copy(std::string_view text)
+    {
+        if (text.empty())
+        {
+            return std::string_view();
+        }
+        char *destination = static_cast<char *>(allocate(text.size(), 1));
+        std::memcpy(destination, text.data(), text.size());
+        return std::string_view(destination, text.size());
+    }
+
+    /**
+     * @brief Frees every block; all pointers handed out become invalid.
+     */
+    void release()
+    {
+        blocks.clear();
+        forget();
+    }
+
+    /**
+     * @brief Returns the number of heap blocks currently held.
+     */
+    size_t blockCount() const { return blocks.size(); }
+
+    /**
+     * @brief Returns the total size of all blocks in bytes.
+     */
+    size_t bytesReserved() const { return reserved; }
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks; // Owned blocks, oldest first
+    char *cursor = nullptr;                      // Next free byte of the newest block
+    size_t remaining = 0;                        // Free bytes left in the newest block
+    size_t nextBlockSize;                        // Size of the next block to allocate
+    size_t reserved = 0;                         // Sum of all block sizes
+
+    void forget()
+    {
+        blocks.clear();
+        cursor = nullptr;
+        remaining = 0;
+        reserved = 0;
+    }
+
+    void addBlock(size_t minimumBytes)
+    {
+        size_t blockSize = nextBlockSize;
+        while (blockSize < minimumBytes)
+        {
+            blockSize *= 2;
+        }
+        blocks.emplace_back(new char[blockSize]);
+        cursor = blocks.back().get();
+        remaining = blockSize;
+        reserved += blockSize;
+        nextBlockSize = blockSize * 2;
+    }
+};
+
+#endif // MONOTONICARENA_HPP
@@ -0,0 +1,251 @@
+#ifndef OUTPUTBUFFER_HPP
+#define OUTPUTBUFFER_HPP
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief The OutputBuffer class collects serialized text in a preallocated buffer.
+ *
+ * In memory mode the buffer simply grows and str() returns the result. In file mode the buffer
+ * has a fixed capacity and is written out in large blocks when full; a piece larger than half the
+ * capacity is written together with the pending buffer in one vectored write (writev on POSIX)
+ * instead of being copied. Numbers are formatted with std::to_chars directly into the buffer.
+ *
+ * The destructor flushes but cannot report errors; call close() to be told about failed writes.
+ */
+class OutputBuffer
+{
+public:
+    static constexpr size_t defaultCapacity = 256 * 1024;
+
+    /**
+     * @brief Creates an in-memory buffer.
+     * @param capacity The number of bytes to preallocate.
+     */
+    explicit OutputBuffer(size_t capacity = defaultCapacity)
+    {
+        buffer.reserve(capacity);
+    }
+
+    /**
+     * @brief Creates a buffer that writes to a file, replacing its contents.
+     * @param path The output file path.
+     * @param capacity The size of the write buffer in bytes.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    explicit OutputBuffer(const std::string &path, size_t capacity = defaultCapacity)
+        : toFile(true), path(path)
+    {
+        buffer.reserve(capacity < 64 ? 64 : capacity);
+#ifdef _WIN32
+        file = std::fopen(path.c_str(), "wb");
+        if (!file)
+        {
+            throw std::runtime_error("Error opening output file: " + path);
+        }
+        std::setvbuf(file, nullptr, _IONBF, 0); // This class already buffers
+#else
+        descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (descriptor < 0)
+        {
+            throw std::runtime_error("Error opening output file: " + path);
+        }
+#endif
+    }
+
+    ~OutputBuffer()
+    {
+        try
+        {
+            close();
+        }
+        catch (const std::exception &)
+        {
+            // Destructors must not throw; close() reports errors to callers that ask
+        }
+    }
+
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    void append(std::string_view text)
+    {
+        if (toFile && buffer.size() + text.size() > buffer.capacity())
+        {
+            if (text.size() > buffer.capacity() / 2)
+            {
+                writeBoth(text);
+                return;
+            }
+            flush();
+        }
+        buffer.append(text.data(), text.size());
+    }
+
+    void append(char c)
+    {
+        if (toFile && buffer.size() == buffer.capacity())
+        {
+            flush();
+        }
+        buffer.push_back(c);
+    }
+
+    void appendInteger(int64_t value)
+    {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        append(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+    }
+
+    /**
+     * @brief Appends the shortest text that reads back as the same double.
+     * Non-finite values have no portable text form; the caller decides what to write for them.
+     */
+    void appendDouble(double value)
+    {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        append(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+    }
+
+    /**
+     * @brief Writes the buffered bytes to the file (no-op in memory mode).
+     * @throws std::runtime_error if the write fails.
+     */
+    void flush()
+    {
+        if (!toFile || buffer.empty())
+        {
+            return;
+        }
+        writeAll(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+    /**
+     * @brief Flushes and closes the file (no-op in memory mode or when already closed).
+     * @throws std::runtime_error if a write fails.
+     */
+    void close()
+    {
+        if (!toFile || !isOpen())
+        {
+            return;
+        }
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+            closeHandle();
+            throw;
+        }
+        closeHandle();
+    }
+
+    /**
+     * @brief Returns the text collected in memory mode.
+     */
+    const std::string &str() const { return buffer; }
+
+private:
+    std::string buffer;
+    bool toFile = false;
+    std::string path;
+#ifdef _WIN32
+    std::FILE *file = nullptr;
+    bool isOpen() const { return file != nullptr; }
+#else
+    int descriptor = -1;
+    bool isOpen() const { return descriptor >= 0; }
+#endif
+
+    [[noreturn]] void fail() const
+    {
+        throw std::runtime_error("Error writing output file: " + path);
+    }
+
+    void closeHandle()
+    {
+#ifdef _WIN32
+        std::fclose(file);
+        file = nullptr;
+#else
+        ::close(descriptor);
+        descriptor = -1;
+#endif
+    }
+
+    void writeAll(const char *data, size_t size)
+    {
+#ifdef _WIN32
+        if (std::fwrite(data, 1, size, file) != size)
+            fail();
+#else
+        while (size > 0)
+        {
+            ssize_t written = ::write(descriptor, data, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                fail();
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+#endif
+    }
+
+    // Writes the pending buffer followed by a large piece without copying the piece.
+    void writeBoth(std::string_view text)
+    {
+#ifdef _WIN32
+        flush();
+        writeAll(text.data(), text.size());
+#else
+        iovec pieces[2] = {{const_cast<char *>(buffer.data()), buffer.size()},
+                           {const_cast<char *>(text.data()), text.size()}};
+        int first = buffer.empty() ? 1 : 0;
+        while (first < 2)
+        {
+            ssize_t written = ::writev(descriptor, pieces + first, 2 - first);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                fail();
+            }
+            size_t remaining = static_cast<size_t>(written);
+            while (first < 2 && remaining >= pieces[first].iov_len)
+            {
+                remaining -= pieces[first].iov_len;
+                ++first;
+            }
+            if (first < 2)
+            {
+                pieces[first].iov_base = static_cast<char *>(pieces[first].iov_base) + remaining;
+                pieces[first].iov_len -= remaining;
+            }
+        }
+        buffer.clear();
+#endif
+    }
+};
+
+#endif // OUTPUTBUFFER_HPP
@@ -0,0 +1,227 @@
+#ifndef PARSECACHE_HPP
+#define PARSECACHE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "MappedFile.hpp"
+
+/**
+ * @brief The ParseCache class keeps the results of parsing files so repeated parses of unchanged
+ * files are served from memory.
+ *
+ * Entries are keyed by the file path and a caller-chosen kind (e.g. "JSON" or "document"), and
+ * remember the file's size, modification time and a hash of its content. A lookup first compares
+ * size and modification time; if either changed, the file is hashed and re-parsed only when the
+ * content really differs. A modification time too close to the moment the file was read cannot
+ * rule out a later write within the same timestamp tick, so such entries are re-hashed on their
+ * next lookup. Files are read into memory (MappedFile::copyOf) rather than mapped, so a result that
+ * points into its file is unaffected when the file is rewritten or truncated later; results are
+ * shared and immutable. The least recently used entries are dropped when the estimated memory of
+ * all results exceeds the budget.
+ *
+ * All methods may be called from several threads. Parsing happens outside the lock, so concurrent
+ * misses on the same file may parse it twice.
+ */
+template <typename Result>
+class ParseCache
+{
+public:
+    using Loader = std::function<Result(const std::shared_ptr<const MappedFile> &file)>;
+    using Measure = std::function<size_t(const Result &result, const MappedFile &file)>;
+
+    /**
+     * @brief Creates an empty cache.
+     * @param memoryBudget The maximum total estimated size of the cached results in bytes.
+     * @param measure Estimates the memory held by one result parsed from the given file.
+     */
+    ParseCache(size_t memoryBudget, Measure measure) : budget(memoryBudget), measure(std::move(measure)) {}
+
+    ParseCache(const ParseCache &) = delete;
+    ParseCache &operator=(const ParseCache &) = delete;
+
+    /**
+     * @brief Returns the cached result for a file, parsing it with load() if the file is not
+     * cached or has changed.
+     * @param path The file path.
+     * @param kind Distinguishes different results parsed from the same file.
+     * @param load Parses the file contents; it may keep them alive inside its result.
+     * @return The shared result.
+     * @throws std::runtime_error if the file cannot be read; exceptions from load() propagate and
+     * leave no entry behind.
+     */
+    std::shared_ptr<const Result> get(const std::string &path, std::string_view kind, const Loader &load)
+    {
+        std::string key = std::string(kind) + '\n' + std::filesystem::absolute(path).lexically_normal().string();
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        std::filesystem::file_time_type modified = error ? std::filesystem::file_time_type() : std::filesystem::last_write_time(path, error);
+        if (error)
+        {
+            erase(key); // Removed or unreadable; MappedFile below reports why
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = entries.find(key);
+            if (found != entries.end() && !found->second->racy && found->second->size == size && found->second->modified == modified)
+            {
+                ++hitCount;
+                touch(found->second);
+                return found->second->result;
+            }
+        }
+
+        auto file = std::make_shared<const MappedFile>(MappedFile::copyOf(path));
+        uint64_t hash = std::hash<std::string_view>()(file->view());
+        bool racy = isRacy(modified);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = entries.find(key);
+            if (found != entries.end() && found->second->hash == hash && found->second->size == file->size())
+            {
+                // Touched or rewritten with the same content
+                ++hitCount;
+                found->second->modified = modified;
+                found->second->racy = racy;
+                touch(found->second);
+                return found->second->result;
+            }
+            ++missCount;
+        }
+
+        auto result = std::make_shared<const Result>(load(file));
+        size_t cost = measure(*result, *file) + key.size() + sizeof(Entry);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        removeLocked(key);
+        if (cost <= budget)
+        {
+            order.push_front(Entry{key, file->size(), modified, hash, racy, result, cost});
+            entries[key] = order.begin();
+            used += cost;
+            evictLocked();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Drops every entry; results already handed out stay valid.
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        order.clear();
+        used = 0;
+    }
+
+    /**
+     * @brief Changes the memory budget, evicting entries until the cache fits.
+     */
+    void setBudget(size_t memoryBudget)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        budget = memoryBudget;
+        evictLocked();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    size_t memoryUsed() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return used;
+    }
+
+    size_t hits() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hitCount;
+    }
+
+    size_t misses() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return missCount;
+    }
+
+    /**
+     * @brief Returns whether a modification time is too recent to rule out another write within
+     * the same timestamp tick, so a copy stamped with it must not be trusted later.
+     */
+    static bool isRacy(std::filesystem::file_time_type modified)
+    {
+        return std::filesystem::file_time_type::clock::now() - modified < racyWindow;
+    }
+
+private:
+    struct Entry
+    {
+        std::string key;
+        uintmax_t size;
+        std::filesystem::file_time_type modified;
+        uint64_t hash;
+        bool racy; // Modified too recently before it was read to trust the timestamp
+        std::shared_ptr<const Result> result;
+        size_t cost;
+    };
+
+    // Timestamps this close to the read may hide a second write in the same tick
+    static constexpr std::chrono::seconds racyWindow{2};
+
+    mutable std::mutex mutex;
+    size_t budget;
+    Measure measure;
+    size_t used = 0;
+    size_t hitCount = 0;
+    size_t missCount = 0;
+    std::list<Entry> order; // Most recently used first
+    std::unordered_map<std::string, typename std::list<Entry>::iterator> entries;
+
+    void touch(typename std::list<Entry>::iterator entry)
+    {
+        order.splice(order.begin(), order, entry);
+    }
+
+    void erase(const std::string &key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        removeLocked(key);
+    }
+
+    void removeLocked(const std::string &key)
+    {
+        auto found = entries.find(key);
+        if (found == entries.end())
+        {
+            return;
+        }
+        used -= found->second->cost;
+        order.erase(found->second);
+        entries.erase(found);
+    }
+
+    void evictLocked()
+    {
+        while (used > budget && !order.empty())
+        {
+            used -= order.back().cost;
+            entries.erase(order.back().key);
+            order.pop_back();
+        }
+    }
+};
+
+#endif // PARSECACHE_HPP
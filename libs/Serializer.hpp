@@ -0,0 +1,468 @@
+#ifndef SERIALIZER_HPP
+#define SERIALIZER_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Document.hpp"
+#include "CsvParser.hpp"
+#include "OutputBuffer.hpp"
+
+/**
+ * @brief The Serializer class writes Documents back out as JSON or XML and CsvTables as CSV.
+ *
+ * All writers append to an OutputBuffer, so the same code produces a std::string or streams a file
+ * in large blocks. The document tape is walked with an explicit stack, so deep documents cannot
+ * exhaust the call stack, and numbers are formatted with std::to_chars.
+ */
+class Serializer
+{
+public:
+    /**
+     * @brief Writes a document as JSON.
+     * Numbers keep their original text when they came from a parser, so values round-trip exactly.
+     * @param document The document to write.
+     * @param out The destination.
+     * @param pretty Whether to indent nested values by two spaces per level.
+     * @throws std::runtime_error if the document is empty.
+     */
+    static void writeJSON(const Document &document, OutputBuffer &out, bool pretty = false)
+    {
+        if (document.empty())
+        {
+            throw std::runtime_error("Document is empty");
+        }
+        struct Frame
+        {
+            size_t end;
+            bool isObject;
+            bool first;
+        };
+        std::vector<Frame> frames;
+        size_t index = 0;
+        while (index < document.nodeCount())
+        {
+            const Document::Node &node = document.nodeAt(index);
+            if (!frames.empty())
+            {
+                Frame &frame = frames.back();
+                if (!frame.first)
+                    out.append(',');
+                frame.first = false;
+                if (pretty)
+                    newline(out, frames.size());
+                if (frame.isObject)
+                {
+                    writeJSONString(node.key, out);
+                    out.append(pretty ? std::string_view(": ") : std::string_view(":"));
+                }
+            }
+            if (node.type == Document::Type::Object || node.type == Document::Type::Array)
+            {
+                bool isObject = node.type == Document::Type::Object;
+                out.append(isObject ? '{' : '[');
+                if (node.size == 0)
+                    out.append(isObject ? '}' : ']');
+                else
+                    frames.push_back(Frame{node.next, isObject, true});
+            }
+            else
+            {
+                writeJSONScalar(node, out);
+            }
+            ++index;
+            while (!frames.empty() && index == frames.back().end)
+            {
+                bool isObject = frames.back().isObject;
+                frames.pop_back();
+                if (pretty)
+                    newline(out, frames.size());
+                out.append(isObject ? '}' : ']');
+            }
+        }
+        if (pretty)
+        {
+            out.append('\n');
+        }
+    }
+
+    /**
+     * @brief Writes a document as XML, following the mapping of XmlPullParser::parseDocument.
+     *
+     * Members named "@name" become attributes and "#text" becomes character data. Array elements
+     * are written as repeated elements named after the array's member. If the root object does not
+     * hold exactly one element, the output is wrapped in a rootName element so it stays well formed;
+     * a root that is not an object is written as an "item" element inside that wrapper.
+     * @param document The document to write.
+     * @param out The destination.
+     * @param rootName The name of the wrapping element, when one is needed.
+     * @throws std::runtime_error if the document is empty.
+     */
+    static void writeXML(const Document &document, OutputBuffer &out, std::string_view rootName = "root")
+    {
+        if (document.empty())
+        {
+            throw std::runtime_error("Document is empty");
+        }
+        const Document::Node &root = document.nodeAt(0);
+        bool singleElement = root.type == Document::Type::Object && root.size == 1 &&
+                             document.nodeAt(1).type != Document::Type::Array && !isAttribute(document.nodeAt(1));
+        bool wrapped = !singleElement && root.type != Document::Type::Object;
+        std::vector<XmlFrame> frames;
+        if (singleElement)
+        {
+            openElement(document, 1, document.nodeAt(1).key, out, frames);
+        }
+        else if (!wrapped)
+        {
+            openElement(document, 0, rootName, out, frames);
+        }
+        else
+        {
+            out.append('<');
+            out.append(rootName);
+            out.append('>');
+            openElement(document, 0, "item", out, frames);
+        }
+        while (!frames.empty())
+        {
+            XmlFrame &frame = frames.back();
+            const Document::Node &container = document.nodeAt(frame.index);
+            if (frame.child >= container.next)
+            {
+                if (container.type == Document::Type::Object)
+                {
+                    out.append("</");
+                    out.append(frame.name);
+                    out.append('>');
+                }
+                frames.pop_back();
+                continue;
+            }
+            size_t child = frame.child;
+            frame.child = document.nodeAt(child).next;
+            if (container.type == Document::Type::Array)
+            {
+                openElement(document, child, frame.name, out, frames);
+                continue;
+            }
+            const Document::Node &member = document.nodeAt(child);
+            if (isAttribute(member))
+            {
+                continue; // Written with the start tag
+            }
+            if (member.key == "#text")
+            {
+                writeXMLText(member, out);
+                continue;
+            }
+            openElement(document, child, member.key, out, frames);
+        }
+        if (wrapped)
+        {
+            out.append("</");
+            out.append(rootName);
+            out.append('>');
+        }
+        out.append('\n');
+    }
+
+    /**
+     * @brief Writes a table as RFC 4180 CSV with '\n' line endings.
+     * String values are always quoted, which makes the parser read them back as String columns;
+     * integral values of Double columns get a ".0" so they are read back as Double; NaN (an empty
+     * field on input) is written as an empty field.
+     * @param table The table to write.
+     * @param out The destination.
+     * @param options Supplies the delimiter, the quote character and whether to write a header.
+     */
+    static void writeCSV(const CsvTable &table, OutputBuffer &out, const CsvOptions &options = CsvOptions())
+    {
+        size_t columnCount = table.columnCount();
+        if (options.hasHeader)
+        {
+            for (size_t col = 0; col < columnCount; ++col)
+            {
+                if (col > 0)
+                    out.append(options.delimiter);
+                writeCSVField(table.column(col).name(), out, options, false);
+            }
+            out.append('\n');
+        }
+        for (size_t row = 0; row < table.rowCount(); ++row)
+        {
+            for (size_t col = 0; col < columnCount; ++col)
+            {
+                if (col > 0)
+                    out.append(options.delimiter);
+                const CsvTable::Column &column = table.column(col);
+                switch (column.type())
+                {
+                case CsvTable::ColumnType::Int64:
+                    out.appendInteger(column.int64Values()[row]);
+                    break;
+                case CsvTable::ColumnType::Double:
+                    writeCSVDouble(column.doubleValues()[row], out);
+                    break;
+                case CsvTable::ColumnType::String:
+                    writeCSVField(column.stringAt(row), out, options, true);
+                    break;
+                }
+            }
+            out.append('\n');
+        }
+    }
+
+    /**
+     * @brief Returns the document as a JSON string.
+     */
+    static std::string toJSON(const Document &document, bool pretty = false)
+    {
+        OutputBuffer out(document.nodeCount() * 16);
+        writeJSON(document, out, pretty);
+        return out.str();
+    }
+
+    /**
+     * @brief Returns the document as an XML string.
+     */
+    static std::string toXML(const Document &document, std::string_view rootName = "root")
+    {
+        OutputBuffer out(document.nodeCount() * 24);
+        writeXML(document, out, rootName);
+        return out.str();
+    }
+
+    /**
+     * @brief Returns the table as a CSV string.
+     */
+    static std::string toCSV(const CsvTable &table, const CsvOptions &options = CsvOptions())
+    {
+        OutputBuffer out(table.rowCount() * table.columnCount() * 8 + 64);
+        writeCSV(table, out, options);
+        return out.str();
+    }
+
+private:
+    /**
+     * @brief An element whose children are still being written.
+     */
+    struct XmlFrame
+    {
+        size_t index;          // The object or array node
+        size_t child;          // The next child to visit
+        std::string_view name; // The element name; arrays pass it on to their elements
+    };
+
+    static void newline(OutputBuffer &out, size_t depth)
+    {
+        out.append('\n');
+        for (size_t i = 0; i < depth; ++i)
+            out.append("  ");
+    }
+
+    static void writeNumberText(const Document::Node &node, OutputBuffer &out, std::string_view nonFinite)
+    {
+        if (!node.text.empty())
+            out.append(node.text);
+        else if (std::isfinite(node.number))
+            out.appendDouble(node.number);
+        else
+            out.append(nonFinite);
+    }
+
+    static void writeJSONScalar(const Document::Node &node, OutputBuffer &out)
+    {
+        switch (node.type)
+        {
+        case Document::Type::Null:
+            out.append("null");
+            break;
+        case Document::Type::Boolean:
+            out.append(node.number != 0.0 ? std::string_view("true") : std::string_view("false"));
+            break;
+        case Document::Type::Number:
+            writeNumberText(node, out, "null");
+            break;
+        default:
+            writeJSONString(node.text, out);
+            break;
+        }
+    }
+
+    static void writeJSONString(std::string_view text, OutputBuffer &out)
+    {
+        static const char hex[] = "0123456789abcdef";
+        out.append('"');
+        size_t run = 0;
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c != '"' && c != '\\' && c >= 0x20)
+            {
+                continue;
+            }
+            out.append(text.substr(run, i - run));
+            run = i + 1;
+            switch (c)
+            {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            case '\b': out.append("\\b"); break;
+            case '\f': out.append("\\f"); break;
+            default:
+                out.append("\\u00");
+                out.append(hex[c >> 4]);
+                out.append(hex[c & 0xF]);
+                break;
+            }
+        }
+        out.append(text.substr(run));
+        out.append('"');
+    }
+
+    static bool isAttribute(const Document::Node &node)
+    {
+        return !node.key.empty() && node.key[0] == '@' && node.type != Document::Type::Object && node.type != Document::Type::Array;
+    }
+
+    static void writeXMLEscaped(std::string_view text, OutputBuffer &out, bool inAttribute)
+    {
+        size_t run = 0;
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            std::string_view entity;
+            switch (text[i])
+            {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            case '"':
+                if (inAttribute)
+                    entity = "&quot;";
+                break;
+            default:
+                break;
+            }
+            if (entity.empty())
+            {
+                continue;
+            }
+            out.append(text.substr(run, i - run));
+            out.append(entity);
+            run = i + 1;
+        }
+        out.append(text.substr(run));
+    }
+
+    static void writeXMLText(const Document::Node &node, OutputBuffer &out)
+    {
+        if (node.type == Document::Type::Number)
+            writeNumberText(node, out, "NaN");
+        else if (node.type == Document::Type::Boolean)
+            out.append(node.number != 0.0 ? std::string_view("true") : std::string_view("false"));
+        else if (node.type == Document::Type::String)
+            writeXMLEscaped(node.text, out, false);
+    }
+
+    // Writes the start of the element for a node; containers are pushed to finish later.
+    static void openElement(const Document &document, size_t index, std::string_view name, OutputBuffer &out, std::vector<XmlFrame> &frames)
+    {
+        const Document::Node &node = document.nodeAt(index);
+        if (node.type == Document::Type::Array)
+        {
+            frames.push_back(XmlFrame{index, index + 1, name});
+            return;
+        }
+        out.append('<');
+        out.append(name);
+        if (node.type != Document::Type::Object)
+        {
+            if (node.type == Document::Type::Null)
+            {
+                out.append("/>");
+                return;
+            }
+            out.append('>');
+            writeXMLText(node, out);
+            out.append("</");
+            out.append(name);
+            out.append('>');
+            return;
+        }
+        bool hasContent = false;
+        for (size_t child = index + 1; child < node.next; child = document.nodeAt(child).next)
+        {
+            const Document::Node &member = document.nodeAt(child);
+            if (!isAttribute(member))
+            {
+                hasContent = true;
+                continue;
+            }
+            out.append(' ');
+            out.append(member.key.substr(1));
+            out.append("=\"");
+            writeXMLText(member, out);
+            out.append('"');
+        }
+        if (!hasContent)
+        {
+            out.append("/>");
+            return;
+        }
+        out.append('>');
+        frames.push_back(XmlFrame{index, index + 1, name});
+    }
+
+    static void writeCSVDouble(double value, OutputBuffer &out)
+    {
+        if (std::isnan(value))
+        {
+            return;
+        }
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        std::string_view text(digits, static_cast<size_t>(result.ptr - digits));
+        out.append(text);
+        if (text.find_first_of(".eEin") == std::string_view::npos)
+        {
+            out.append(".0"); // Keep the column Double when it is parsed again
+        }
+    }
+
+    static void writeCSVField(std::string_view text, OutputBuffer &out, const CsvOptions &options, bool alwaysQuote)
+    {
+        bool quote = alwaysQuote;
+        for (size_t i = 0; i < text.size() && !quote; ++i)
+        {
+            char c = text[i];
+            quote = c == options.delimiter || c == options.quote || c == '\r' || c == '\n';
+        }
+        if (!quote)
+        {
+            out.append(text);
+            return;
+        }
+        out.append(options.quote);
+        size_t run = 0;
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            if (text[i] == options.quote)
+            {
+                out.append(text.substr(run, i + 1 - run)); // Includes the quote, then doubles it
+                out.append(options.quote);
+                run = i + 1;
+            }
+        }
+        out.append(text.substr(run));
+        out.append(options.quote);
+    }
+};
+
+#endif // SERIALIZER_HPP
@@ -0,0 +1,646 @@
+#ifndef STREAMINGPARSER_HPP
+#define STREAMINGPARSER_HPP
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Document.hpp"
+#include "JsonParser.hpp"
+#include "XmlParser.hpp"
+
+/**
+ * @brief Callbacks invoked by the streaming parsers as the input is consumed.
+ *
+ * Every format is reported with the same vocabulary:
+ * - JSON maps one to one (objects, arrays, keys and typed scalar values).
+ * - XML reports each element as onKey(tag) followed by onStartObject/onEndObject; attributes are
+ *   keys prefixed with '@' and character data is reported under the "#text" key.
+ * - CSV reports the file as an array of row objects whose keys are the header fields.
+ *
+ * Unset callbacks are skipped. The string_views passed to callbacks are only valid during the call.
+ */
+struct ParseHandler
+{
+    std::function<void()> onStartObject;
+    std::function<void()> onEndObject;
+    std::function<void()> onStartArray;
+    std::function<void()> onEndArray;
+    std::function<void(std::string_view key)> onKey;
+    std::function<void(std::string_view value, Document::Type type)> onValue;
+};
+
+/**
+ * @brief Incremental JSON parser: accepts the input in arbitrary chunks and emits ParseHandler events.
+ * Memory use is bounded by the nesting depth and the longest single string or number.
+ */
+class JsonStreamParser
+{
+public:
+    explicit JsonStreamParser(ParseHandler handler) : handler(std::move(handler)) {}
+
+    /**
+     * @brief Consumes the next chunk of input.
+     * @param chunk The bytes following the previously fed chunk.
+     * @throws std::runtime_error if the input is not valid JSON.
+     */
+    void feed(std::string_view chunk)
+    {
+        size_t base = offset;
+        size_t i = 0;
+        while (i < chunk.size())
+        {
+            offset = base + i;
+            if (inString)
+            {
+                i = consumeString(chunk, i);
+                continue;
+            }
+            char c = chunk[i];
+            if (inScalar)
+            {
+                if (!isDelimiter(c))
+                {
+                    token.push_back(c);
+                    ++i;
+                    continue;
+                }
+                completeScalar();
+            }
+            consumeStructural(c);
+            ++i;
+        }
+        offset = base + chunk.size();
+    }
+
+    /**
+     * @brief Signals the end of input.
+     * @throws std::runtime_error if the document is incomplete.
+     */
+    void finish()
+    {
+        if (inScalar)
+        {
+            completeScalar();
+        }
+        if (inString || state != State::Done)
+        {
+            throw std::runtime_error("Unexpected end of JSON input");
+        }
+    }
+
+private:
+    enum class State
+    {
+        Value,      // A value is required (root, after ':' or after ',' in an array)
+        ValueOrEnd, // Just after '['
+        KeyOrEnd,   // Just after '{'
+        Key,        // After ',' in an object
+        Colon,      // After an object key
+        CommaOrEnd, // After a value inside a container
+        Done        // The root value is complete
+    };
+
+    ParseHandler handler;
+    State state = State::Value;
+    std::vector<char> containers; // Open '{' and '[' from outermost to innermost
+    std::string token;            // Raw bytes of the string or scalar being read
+    bool inString = false;
+    bool stringIsKey = false;
+    bool escapePending = false;
+    bool hasEscapes = false;
+    bool inScalar = false;
+    size_t offset = 0; // Input position, for error messages
+
+    static bool isWhitespace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    static bool isDelimiter(char c)
+    {
+        return isWhitespace(c) || c == ',' || c == ':' || c == '{' || c == '}' || c == '[' || c == ']' || c == '"';
+    }
+
+    [[noreturn]] void fail(const std::string &message) const
+    {
+        throw std::runtime_error("Invalid JSON at offset " + std::to_string(offset) + ": " + message);
+    }
+
+    bool expectsValue() const { return state == State::Value || state == State::ValueOrEnd; }
+
+    void valueCompleted()
+    {
+        state = containers.empty() ? State::Done : State::CommaOrEnd;
+    }
+
+    // Copies string bytes up to the next quote or backslash in one go; returns the next position.
+    size_t consumeString(std::string_view chunk, size_t i)
+    {
+        if (escapePending)
+        {
+            token.push_back(chunk[i]);
+            escapePending = false;
+            return i + 1;
+        }
+        size_t stop = chunk.find_first_of("\"\\", i);
+        if (stop == std::string_view::npos)
+        {
+            token.append(chunk.data() + i, chunk.size() - i);
+            return chunk.size();
+        }
+        token.append(chunk.data() + i, stop - i);
+        if (chunk[stop] == '\\')
+        {
+            token.push_back('\\');
+            escapePending = true;
+            hasEscapes = true;
+            return stop + 1;
+        }
+        inString = false;
+        std::string decoded = hasEscapes ? JsonParser::unescape(token) : std::string();
+        std::string_view text = hasEscapes ? std::string_view(decoded) : std::string_view(token);
+        if (stringIsKey)
+        {
+            if (handler.onKey)
+                handler.onKey(text);
+            state = State::Colon;
+        }
+        else
+        {
+            if (handler.onValue)
+                handler.onValue(text, Document::Type::String);
+            valueCompleted();
+        }
+        token.clear();
+        return stop + 1;
+    }
+
+    void completeScalar()
+    {
+        inScalar = false;
+        Document::Type type = Document::Type::Number;
+        if (token == "true" || token == "false")
+            type = Document::Type::Boolean;
+        else if (token == "null")
+            type = Document::Type::Null;
+        else
+            JsonParser::parseNumber(token);
+        if (handler.onValue)
+            handler.onValue(token, type);
+        token.clear();
+        valueCompleted();
+    }
+
+    void consumeStructural(char c)
+    {
+        if (isWhitespace(c))
+        {
+            return;
+        }
+        if (state == State::Done)
+        {
+            fail("unexpected content after document");
+        }
+        switch (c)
+        {
+        case '{':
+        case '[':
+            if (!expectsValue())
+                fail("unexpected bracket");
+            containers.push_back(c);
+            if (c == '{')
+            {
+                if (handler.onStartObject)
+                    handler.onStartObject();
+                state = State::KeyOrEnd;
+            }
+            else
+            {
+                if (handler.onStartArray)
+                    handler.onStartArray();
+                state = State::ValueOrEnd;
+            }
+            break;
+        case '}':
+        case ']':
+        {
+            bool closesObject = c == '}';
+            bool allowed = closesObject ? (state == State::KeyOrEnd || state == State::CommaOrEnd)
+                                        : (state == State::ValueOrEnd || state == State::CommaOrEnd);
+            if (!allowed || containers.empty() || containers.back() != (closesObject ? '{' : '['))
+                fail("unexpected closing bracket");
+            containers.pop_back();
+            if (closesObject && handler.onEndObject)
+                handler.onEndObject();
+            if (!closesObject && handler.onEndArray)
+                handler.onEndArray();
+            valueCompleted();
+            break;
+        }
+        case ',':
+            if (state != State::CommaOrEnd)
+                fail("unexpected ','");
+            state = containers.back() == '{' ? State::Key : State::Value;
+            break;
+        case ':':
+            if (state != State::Colon)
+                fail("unexpected ':'");
+            state = State::Value;
+            break;
+        case '"':
+            if (state == State::KeyOrEnd || state == State::Key)
+                stringIsKey = true;
+            else if (expectsValue())
+                stringIsKey = false;
+            else
+                fail("unexpected string");
+            inString = true;
+            hasEscapes = false;
+            break;
+        default:
+            if (!expectsValue())
+                fail("unexpected value");
+            inScalar = true;
+            token.push_back(c);
+            break;
+        }
+    }
+};
+
+/**
+ * @brief Incremental XML parser: accepts the input in arbitrary chunks and emits ParseHandler events.
+ * Comments, processing instructions and declarations are skipped; CDATA is reported as text.
+ */
+class XmlStreamParser
+{
+public:
+    explicit XmlStreamParser(ParseHandler handler) : handler(std::move(handler)) {}
+
+    /**
+     * @brief Consumes the next chunk of input.
+     * @param chunk The bytes following the previously fed chunk.
+     * @throws std::runtime_error if the markup is malformed.
+     */
+    void feed(std::string_view chunk)
+    {
+        size_t i = 0;
+        while (i < chunk.size())
+        {
+            switch (state)
+            {
+            case State::Text:
+            {
+                size_t open = chunk.find('<', i);
+                size_t stop = open == std::string_view::npos ? chunk.size() : open;
+                text.append(chunk.data() + i, stop - i);
+                i = stop;
+                if (open != std::string_view::npos)
+                {
+                    state = State::Markup;
+                    markup.clear();
+                    quote = 0;
+                    ++i;
+                }
+                break;
+            }
+            case State::Markup:
+                i = consumeMarkup(chunk, i);
+                break;
+            case State::Skip:
+            {
+                size_t stop = std::min(chunk.size(), i + 1);
+                markup.append(chunk.data() + i, stop - i);
+                i = stop;
+                if (markup.size() >= terminator.size() &&
+                    markup.compare(markup.size() - terminator.size(), terminator.size(), terminator) == 0)
+                {
+                    completeSkipped();
+                }
+                break;
+            }
+            }
+        }
+    }
+
+    /**
+     * @brief Signals the end of input.
+     * @throws std::runtime_error if elements are left open or markup is unterminated.
+     */
+    void finish()
+    {
+        if (state != State::Text || !elements.empty())
+        {
+            throw std::runtime_error("Unexpected end of XML input");
+        }
+    }
+
+private:
+    enum class State
+    {
+        Text,   // Character data between tags
+        Markup, // Inside '<' ... '>'
+        Skip    // Inside a comment, CDATA section or processing instruction
+    };
+
+    ParseHandler handler;
+    State state = State::Text;
+    std::string text;                  // Pending character data of the current element
+    std::string markup;                // Bytes of the tag being read
+    std::string terminator;            // End marker while in the Skip state
+    std::vector<std::string> elements; // Open element names from outermost to innermost
+    char quote = 0;                    // Active attribute quote inside a tag
+
+    static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    size_t consumeMarkup(std::string_view chunk, size_t i)
+    {
+        for (; i < chunk.size(); ++i)
+        {
+            char c = chunk[i];
+            if (quote)
+            {
+                if (c == quote)
+                    quote = 0;
+            }
+            else if (c == '"' || c == '\'')
+            {
+                quote = c;
+            }
+            else if (c == '>')
+            {
+                state = State::Text;
+                completeTag();
+                return i + 1;
+            }
+            markup.push_back(c);
+            if (markup == "!--" || markup == "![CDATA[" || markup == "?")
+            {
+                terminator = markup == "!--" ? "-->" : markup == "?" ? "?>" : "]]>";
+                state = State::Skip;
+                return i + 1;
+            }
+        }
+        return i;
+    }
+
+    void completeSkipped()
+    {
+        if (terminator == "]]>")
+        {
+            // CDATA content is literal text; escape '&' so decodeEntities leaves it untouched.
+            std::string_view content(markup.data() + 8, markup.size() - 8 - 3);
+            for (char c : content)
+            {
+                if (c == '&')
+                    text += "&amp;";
+                else
+                    text.push_back(c);
+            }
+        }
+        markup.clear();
+        state = State::Text;
+    }
+
+    void flushText()
+    {
+        size_t first = 0;
+        while (first < text.size() && isSpace(text[first]))
+            ++first;
+        size_t last = text.size();
+        while (last > first && isSpace(text[last - 1]))
+            --last;
+        if (last > first)
+        {
+            if (elements.empty())
+            {
+                throw std::runtime_error("XML text outside of the root element");
+            }
+            std::string decoded = XmlPullParser::decodeEntities(std::string_view(text).substr(first, last - first));
+            if (handler.onKey)
+                handler.onKey("#text");
+            if (handler.onValue)
+                handler.onValue(decoded, Document::Type::String);
+        }
+        text.clear();
+    }
+
+    void completeTag()
+    {
+        if (markup.empty())
+        {
+            throw std::runtime_error("Empty XML tag");
+        }
+        if (markup[0] == '!')
+        {
+            markup.clear(); // <!DOCTYPE ...> and other declarations
+            return;
+        }
+        flushText();
+        if (markup[0] == '/')
+        {
+            std::string_view name(markup);
+            name.remove_prefix(1);
+            while (!name.empty() && isSpace(name.back()))
+                name.remove_suffix(1);
+            if (elements.empty() || elements.back() != name)
+            {
+                throw std::runtime_error("Mismatched XML closing tag: " + std::string(name));
+            }
+            elements.pop_back();
+            if (handler.onEndObject)
+                handler.onEndObject();
+            return;
+        }
+        bool selfClosing = markup.back() == '/';
+        std::string_view tag(markup);
+        if (selfClosing)
+            tag.remove_suffix(1);
+        size_t nameEnd = 0;
+        while (nameEnd < tag.size() && !isSpace(tag[nameEnd]))
+            ++nameEnd;
+        std::string name(tag.substr(0, nameEnd));
+        if (handler.onKey)
+            handler.onKey(name);
+        if (handler.onStartObject)
+            handler.onStartObject();
+        emitAttributes(tag.substr(nameEnd));
+        if (selfClosing)
+        {
+            if (handler.onEndObject)
+                handler.onEndObject();
+        }
+        else
+        {
+            elements.push_back(std::move(name));
+        }
+    }
+
+    void emitAttributes(std::string_view attributes)
+    {
+        size_t i = 0;
+        while (i < attributes.size())
+        {
+            while (i < attributes.size() && isSpace(attributes[i]))
+                ++i;
+            size_t nameStart = i;
+            while (i < attributes.size() && attributes[i] != '=' && !isSpace(attributes[i]))
+                ++i;
+            if (nameStart == i)
+                break;
+            std::string key = "@" + std::string(attributes.substr(nameStart, i - nameStart));
+            while (i < attributes.size() && (isSpace(attributes[i]) || attributes[i] == '='))
+                ++i;
+            if (i >= attributes.size() || (attributes[i] != '"' && attributes[i] != '\''))
+            {
+                throw std::runtime_error("Malformed XML attribute: " + key.substr(1));
+            }
+            char delimiter = attributes[i++];
+            size_t valueEnd = attributes.find(delimiter, i);
+            if (valueEnd == std::string_view::npos)
+            {
+                throw std::runtime_error("Unterminated XML attribute: " + key.substr(1));
+            }
+            std::string value = XmlPullParser::decodeEntities(attributes.substr(i, valueEnd - i));
+            if (handler.onKey)
+                handler.onKey(key);
+            if (handler.onValue)
+                handler.onValue(value, Document::Type::String);
+            i = valueEnd + 1;
+        }
+    }
+};
+
+/**
+ * @brief Incremental CSV parser: accepts the input in arbitrary chunks and emits ParseHandler events.
+ * The first record supplies the keys; every following record is reported as one object.
+ * Quoted fields may contain delimiters, doubled quotes and line breaks.
+ */
+class CsvStreamParser
+{
+public:
+    explicit CsvStreamParser(ParseHandler handler, char delimiter = ',') : handler(std::move(handler)), delimiter(delimiter) {}
+
+    /**
+     * @brief Consumes the next chunk of input.
+     * @param chunk The bytes following the previously fed chunk.
+     */
+    void feed(std::string_view chunk)
+    {
+        if (!started)
+        {
+            started = true;
+            if (handler.onStartArray)
+                handler.onStartArray();
+        }
+        for (char c : chunk)
+        {
+            if (inQuotes)
+            {
+                if (quotePending)
+                {
+                    quotePending = false;
+                    if (c == '"')
+                    {
+                        field.push_back('"');
+                        continue;
+                    }
+                    inQuotes = false; // The pending quote closed the field; handle c below
+                }
+                else
+                {
+                    if (c == '"')
+                        quotePending = true;
+                    else
+                        field.push_back(c);
+                    continue;
+                }
+            }
+            if (c == '"' && field.empty())
+            {
+                inQuotes = true;
+            }
+            else if (c == delimiter)
+            {
+                completeField();
+            }
+            else if (c == '\n')
+            {
+                completeRecord();
+            }
+            else if (c != '\r')
+            {
+                field.push_back(c);
+            }
+        }
+    }
+
+    /**
+     * @brief Signals the end of input, flushing a final record without a trailing newline.
+     * @throws std::runtime_error if a quoted field is unterminated.
+     */
+    void finish()
+    {
+        if (inQuotes && !quotePending)
+        {
+            throw std::runtime_error("Unterminated quoted CSV field");
+        }
+        inQuotes = false;
+        quotePending = false;
+        if (!field.empty() || !record.empty())
+        {
+            completeRecord();
+        }
+        if (!started && handler.onStartArray)
+            handler.onStartArray();
+        started = true;
+        if (handler.onEndArray)
+            handler.onEndArray();
+    }
+
+private:
+    ParseHandler handler;
+    char delimiter;
+    std::vector<std::string> header; // Keys taken from the first record
+    std::vector<std::string> record; // Fields of the record being read
+    std::string field;               // Bytes of the field being read
+    bool started = false;
+    bool inQuotes = false;
+    bool quotePending = false; // A quote inside a quoted field: either an escape or the closing quote
+
+    void completeField()
+    {
+        record.push_back(std::move(field));
+        field.clear();
+    }
+
+    void completeRecord()
+    {
+        completeField();
+        if (record.size() == 1 && record[0].empty())
+        {
+            record.clear(); // Blank line
+            return;
+        }
+        if (header.empty())
+        {
+            header = std::move(record);
+            record.clear();
+            return;
+        }
+        if (handler.onStartObject)
+            handler.onStartObject();
+        for (size_t i = 0; i < record.size(); ++i)
+        {
+            std::string key = i < header.size() ? header[i] : std::to_string(i);
+            if (handler.onKey)
+                handler.onKey(key);
+            if (handler.onValue)
+                handler.onValue(record[i], Document::Type::String);
+        }
+        if (handler.onEndObject)
+            handler.onEndObject();
+        record.clear();
+    }
+};
+
+#endif // STREAMINGPARSER_HPP
@@ -0,0 +1,120 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief The ThreadPool class runs submitted tasks on a fixed set of worker threads.
+ *
+ * Tasks are taken in submission order from a shared queue. The destructor finishes every task
+ * that was already submitted before joining the workers.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threadCount The number of workers; 0 uses the number of hardware threads.
+     */
+    explicit ThreadPool(size_t threadCount = 0)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        workers.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            workers.emplace_back([this]()
+                                 { workerLoop(); });
+        }
+    }
+
+    /**
+     * @brief Drains the queue and joins all workers.
+     */
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueCondition.notify_all();
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Queues a task for execution.
+     * @param task A callable taking no arguments.
+     * @return A future holding the task's result or the exception it threw.
+     * @throws std::runtime_error if the pool is shutting down.
+     */
+    template <typename Task>
+    auto submit(Task &&task) -> std::future<std::invoke_result_t<std::decay_t<Task>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<Task>>;
+        auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+        std::future<Result> result = packagedTask->get_future();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (stopping)
+            {
+                throw std::runtime_error("ThreadPool is shutting down");
+            }
+            tasks.emplace([packagedTask]()
+                          { (*packagedTask)(); });
+        }
+        queueCondition.notify_one();
+        return result;
+    }
+
+    /**
+     * @brief Returns the number of worker threads.
+     */
+    size_t size() const { return workers.size(); }
+
+private:
+    std::vector<std::thread> workers;        // Worker threads
+    std::queue<std::function<void()>> tasks; // Pending tasks in submission order
+    std::mutex queueMutex;                   // Guards tasks and stopping
+    std::condition_variable queueCondition;  // Signalled when a task arrives or the pool stops
+    bool stopping = false;                   // Set by the destructor
+
+    void workerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCondition.wait(lock, [this]()
+                                    { return stopping || !tasks.empty(); });
+                if (tasks.empty())
+                {
+                    return; // Stopping and fully drained
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+};
+
+#endif // THREADPOOL_HPP
@@ -0,0 +1,967 @@
+#ifndef WATCHSERVICE_HPP
+#define WATCHSERVICE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+#include "Logger.hpp"
+#include "DirectorySnapshot.hpp"
+
+/**
+ * @brief A change reported by WatchService and FileSystemWatcher.
+ */
+struct FileSystemEvent {
+    enum class Type { Created, Modified, Deleted, Renamed };
+
+    Type type = Type::Modified;
+    std::string path;         // The affected entry; for Renamed, its new path
+    std::string oldPath;      // For Renamed, the previous path; empty otherwise
+    bool isDirectory = false; // Whether the entry is a directory
+};
+
+/**
+ * @brief Options for one watched directory.
+ *
+ * Filters are glob patterns: '*' matches within one path component, '**' across components, '?'
+ * one character and [a-z] or [!a-z] a character class. A pattern without '/' is matched against the
+ * entry's name, one with '/' against its path relative to the watched directory.
+ */
+struct WatchOptions {
+    bool recursive = false;                       // Watch subdirectories, including ones created later
+    bool forcePolling = false;                    // Poll even where a native backend (inotify) exists
+    std::chrono::milliseconds pollInterval{1000}; // Delay between scans in polling mode
+    std::chrono::milliseconds debounce{0};        // Quiet period before coalesced events are delivered; 0 delivers at once
+    std::vector<std::string> include;             // Report only entries matching one of these, e.g. "*.json"; empty reports all
+    std::vector<std::string> exclude;             // Never report entries matching one of these, e.g. "*.swp" or "build/**"
+};
+
+/**
+ * @brief The WatchService class watches any number of directories from a single thread.
+ *
+ * On Linux all watches share one inotify descriptor, read by one thread blocked in epoll, so an
+ * idle service costs no CPU however many directories it watches and changes arrive within
+ * milliseconds. Directories that cannot use inotify, and every directory on other platforms, are
+ * polled by the same thread: each scan is a DirectorySnapshot diffed against the previous one.
+ * Watches can be added and removed at any time.
+ *
+ * For each watch, events are filtered, optionally debounced, and delivered as batches to its
+ * callback on the service thread; callbacks should return quickly since they delay all other
+ * watches. A rename between a matching and a non-matching name (or into or out of the watched
+ * tree) is reported as the creation or deletion of the side that is visible. A rename that replaces
+ * an existing entry is preceded by a Deleted event for the replaced entry, as polling sees it.
+ *
+ * Recursive watches register every subdirectory found by an initial scan (parallel on large
+ * trees), each just before it is listed, and each directory that appears later; entries already
+ * inside a new directory are reported as created, which may duplicate events for files written
+ * while it was registered or for directories created during the initial scan.
+ *
+ * With a debounce window, events are held until no new event has arrived for that long (or for at
+ * most ten windows during a continuous stream) and each path is reported once with its net change:
+ * a file created and deleted again produces nothing, created and modified is one Created, and a
+ * temporary file renamed over its target is a Modified event for the target, or a Created event if
+ * the target did not exist before, with either backend.
+ */
+class WatchService {
+public:
+    using WatchId = uint64_t;
+    using BatchCallback = std::function<void(const std::vector<FileSystemEvent> &)>;
+
+    /**
+     * @brief Constructs a WatchService object. The service thread starts with the first watch.
+     */
+    WatchService()
+        : logger([]() {
+            std::string currentFile = __FILE__;
+            std::string::size_type pos = currentFile.find_last_of("/\\");
+            std::string fileName = currentFile.substr(pos + 1, currentFile.rfind(".") - pos - 1);
+            return Logger::getLogsFilename(fileName);
+        }())
+    {
+        logger.log("WatchService instance created");
+    }
+
+    WatchService(const WatchService &) = delete;
+    WatchService &operator=(const WatchService &) = delete;
+
+    /**
+     * @brief Stops the service thread after delivering any events still held for debouncing.
+     */
+    ~WatchService() {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            stopping = true;
+        }
+        wake();
+        if (loopThread.joinable()) {
+            loopThread.join();
+        }
+#ifdef __linux__
+        for (int descriptor : {inotifyDescriptor, epollDescriptor, wakeDescriptor}) {
+            if (descriptor >= 0) {
+                ::close(descriptor);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Returns the process-wide service used by FileSystemWatcher.
+     */
+    static WatchService &shared() {
+        static WatchService service;
+        return service;
+    }
+
+    /**
+     * @brief Starts watching a directory.
+     * Changes made after this returns are reported.
+     *
+     * @param directory The directory to watch.
+     * @param onBatch Called on the service thread with each non-empty batch of events.
+     * @param options Recursion, backend selection, polling interval, debouncing and filters.
+     * @return The identifier to pass to removeWatch.
+     * @throws std::runtime_error if the directory does not exist.
+     */
+    WatchId addWatch(std::string directory, BatchCallback onBatch, const WatchOptions &options = WatchOptions()) {
+        if (!std::filesystem::is_directory(directory)) {
+            log("Cannot watch " + directory + ": not a directory");
+            throw std::runtime_error("Not a directory: " + directory);
+        }
+        directory = std::filesystem::path(directory).lexically_normal().string(); // One spelling per directory
+        while (directory.size() > 1 && (directory.back() == '/' || directory.back() == '\\')) {
+            directory.pop_back();
+        }
+        auto watch = std::make_shared<Watch>();
+        watch->root = directory;
+        watch->options = options;
+        watch->deliver = std::move(onBatch);
+
+        ThreadPool *pool = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            startLocked();
+            watch->id = nextId++;
+            if (options.recursive) {
+                if (!scanPool) {
+                    scanPool = std::make_unique<ThreadPool>();
+                }
+                pool = scanPool.get();
+            }
+            // The root is watched and the watch registered before any scan, so events from then on
+            // are attributed to it, including the creation of directories the scan has not reached
+            watch->native = !options.forcePolling && nativeAvailable && addDirectoryLocked(directory, watch->id, true) >= 0;
+            if (watch->native) {
+                watches[watch->id] = watch;
+            }
+        }
+
+        // Scans run unlocked
+        if (watch->native) {
+            if (options.recursive) {
+                WatchId id = watch->id;
+                DirectorySnapshot::capture(directory, true, pool, [this, id](const std::string& subdirectory) {
+                    std::lock_guard<std::mutex> lock(stateMutex);
+                    if (watches.count(id)) { // Not removed meanwhile
+                        addDirectoryLocked(subdirectory, id, false);
+                    }
+                });
+            }
+        } else {
+            DirectorySnapshot tree = DirectorySnapshot::capture(directory, options.recursive, pool);
+            std::lock_guard<std::mutex> lock(stateMutex);
+            watch->snapshot = std::move(tree);
+            watch->nextScan = std::chrono::steady_clock::now() + options.pollInterval;
+            watches[watch->id] = watch;
+        }
+        wake();
+        log("Started watching " + directory + (options.recursive ? " recursively" : "") + (watch->native ? " (inotify)" : " (polling)"));
+        return watch->id;
+    }
+
+    /**
+     * @brief Stops watching a directory. Events still held for debouncing are delivered first, on
+     * the calling thread. Once this returns the callback is not called again, unless this is
+     * called from the callback itself.
+     *
+     * @param id The identifier returned by addWatch.
+     * @return false if there is no such watch.
+     */
+    bool removeWatch(WatchId id) {
+        std::shared_ptr<Watch> watch;
+        std::vector<FileSystemEvent> held;
+        bool onServiceThread;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            auto found = watches.find(id);
+            if (found == watches.end()) {
+                return false;
+            }
+            watch = found->second;
+            watches.erase(found);
+            releaseDirectoriesLocked(id, std::string());
+            held = std::move(watch->ready);
+            std::vector<FileSystemEvent> coalesced = watch->coalescer.take();
+            held.insert(held.end(), coalesced.begin(), coalesced.end());
+            onServiceThread = std::this_thread::get_id() == loopId;
+        }
+        std::unique_lock<std::mutex> dispatchLock(dispatchMutex, std::defer_lock);
+        if (!onServiceThread) {
+            dispatchLock.lock(); // Waits for a callback in progress
+        }
+        if (watch->active && !held.empty()) {
+            deliverTo(*watch, held);
+        }
+        watch->active = false;
+        log("Stopped watching " + watch->root);
+        return true;
+    }
+
+    /**
+     * @brief Returns whether a watch uses the native (inotify) backend rather than polling.
+     */
+    bool isNative(WatchId id) const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        auto found = watches.find(id);
+        return found != watches.end() && found->second->native;
+    }
+
+    /**
+     * @brief Returns the number of active watches.
+     */
+    size_t watchCount() const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        return watches.size();
+    }
+
+    /**
+     * @brief Matches text against a glob pattern (see WatchOptions for the syntax).
+     */
+    static bool matchesGlob(std::string_view pattern, std::string_view text) {
+        if (pattern.empty()) {
+            return text.empty();
+        }
+        if (pattern[0] == '*') {
+            bool crossesSeparators = pattern.size() > 1 && pattern[1] == '*';
+            std::string_view rest = pattern.substr(crossesSeparators ? 2 : 1);
+            if (crossesSeparators && !rest.empty() && rest[0] == '/') {
+                if (matchesGlob(rest.substr(1), text)) {
+                    return true; // "a/**/b" also matches "a/b"
+                }
+            }
+            for (size_t skip = 0; skip <= text.size(); ++skip) {
+                if (matchesGlob(rest, text.substr(skip))) {
+                    return true;
+                }
+                if (skip < text.size() && text[skip] == '/' && !crossesSeparators) {
+                    return false;
+                }
+            }
+            return false;
+        }
+        if (text.empty()) {
+            return false;
+        }
+        if (pattern[0] == '[') {
+            size_t close = pattern.find(']', 2);
+            if (close != std::string_view::npos) {
+                bool negate = pattern[1] == '!' || pattern[1] == '^';
+                bool matched = false;
+                for (size_t i = negate ? 2 : 1; i < close; ++i) {
+                    if (i + 2 < close && pattern[i + 1] == '-') {
+                        matched = matched || (text[0] >= pattern[i] && text[0] <= pattern[i + 2]);
+                        i += 2;
+                    } else {
+                        matched = matched || text[0] == pattern[i];
+                    }
+                }
+                return matched != negate && text[0] != '/' && matchesGlob(pattern.substr(close + 1), text.substr(1));
+            }
+        }
+        if (pattern[0] == '?' ? text[0] != '/' : pattern[0] == text[0]) {
+            return matchesGlob(pattern.substr(1), text.substr(1));
+        }
+        return false;
+    }
+
+private:
+    // Merges the events of one debounce window so that each path is reported once
+    class Coalescer {
+    public:
+        void add(const FileSystemEvent& event) {
+            using Type = FileSystemEvent::Type;
+            if (event.type == Type::Renamed) {
+                addRename(event);
+                return;
+            }
+            auto found = pending.find(event.path);
+            if (found == pending.end()) {
+                pending.emplace(event.path, Pending{event, false, nextOrder++});
+                return;
+            }
+            Pending& current = found->second;
+            if (event.type == Type::Created && current.event.type == Type::Deleted) {
+                current.event.type = event.isDirectory ? Type::Created : Type::Modified; // Replaced
+                current.event.isDirectory = event.isDirectory;
+            } else if (event.type == Type::Modified) {
+                current.modified = current.event.type == Type::Renamed;
+            } else if (event.type == Type::Deleted) {
+                if (current.event.type == Type::Created) {
+                    pending.erase(found); // Never existed as far as the receiver knows
+                } else if (current.event.type == Type::Renamed) {
+                    // The renamed entry is gone from its old path, where something new may have appeared since
+                    FileSystemEvent deleted = event;
+                    deleted.path = current.event.oldPath;
+                    uint64_t order = current.order;
+                    pending.erase(found);
+                    auto original = pending.find(deleted.path);
+                    if (original == pending.end()) {
+                        pending.emplace(deleted.path, Pending{deleted, false, order});
+                    } else {
+                        Pending& replacement = original->second;
+                        if (replacement.event.type == Type::Created) {
+                            replacement.event.type = replacement.event.isDirectory ? Type::Created : Type::Modified; // Replaced
+                        }
+                        replacement.order = std::min(replacement.order, order);
+                    }
+                } else {
+                    current.event.type = Type::Deleted;
+                    current.modified = false;
+                }
+            }
+        }
+
+        bool empty() const {
+            return pending.empty();
+        }
+
+        // Returns the net changes in the order their paths first changed, and starts a new window
+        std::vector<FileSystemEvent> take() {
+            std::vector<Pending*> ordered;
+            ordered.reserve(pending.size());
+            for (auto& entry : pending) {
+                ordered.push_back(&entry.second);
+            }
+            std::sort(ordered.begin(), ordered.end(), [](const Pending* a, const Pending* b) { return a->order < b->order; });
+            std::vector<FileSystemEvent> events;
+            events.reserve(ordered.size());
+            for (Pending* entry : ordered) {
+                events.push_back(std::move(entry->event));
+                if (entry->modified) {
+                    FileSystemEvent modified;
+                    modified.type = FileSystemEvent::Type::Modified;
+                    modified.path = events.back().path;
+                    events.push_back(std::move(modified));
+                }
+            }
+            pending.clear();
+            return events;
+        }
+
+    private:
+        struct Pending {
+            FileSystemEvent event;
+            bool modified; // Renamed and then written to
+            uint64_t order; // When the path first changed in this window
+        };
+
+        std::unordered_map<std::string, Pending> pending; // Net change by current path
+        uint64_t nextOrder = 0;
+
+        void addRename(const FileSystemEvent& event) {
+            using Type = FileSystemEvent::Type;
+            Pending moved{event, false, nextOrder++};
+            auto source = pending.find(event.oldPath);
+            if (source != pending.end()) {
+                Pending previous = std::move(source->second);
+                pending.erase(source);
+                moved.order = previous.order;
+                moved.modified = previous.modified || previous.event.type == Type::Modified;
+                if (previous.event.type == Type::Created) {
+                    moved.event.type = Type::Created; // e.g. a temporary file renamed into place
+                    moved.event.oldPath.clear();
+                    moved.modified = false;
+                } else if (previous.event.type == Type::Renamed) {
+                    moved.event.oldPath = previous.event.oldPath;
+                }
+            }
+            if (moved.event.type == Type::Renamed && moved.event.oldPath == moved.event.path) {
+                if (!moved.modified) {
+                    return; // Renamed there and back
+                }
+                moved.event.type = Type::Modified;
+                moved.event.oldPath.clear();
+                moved.modified = false;
+            }
+            auto target = pending.find(moved.event.path);
+            if (target != pending.end()) {
+                if (target->second.event.type == Type::Deleted && moved.event.type == Type::Created) {
+                    moved.event.type = Type::Modified; // Replaced
+                }
+                moved.order = std::min(moved.order, target->second.order);
+            }
+            pending[moved.event.path] = std::move(moved);
+        }
+    };
+
+    struct Watch {
+        WatchId id = 0;
+        std::string root;
+        WatchOptions options;
+        BatchCallback deliver;
+        bool native = false;
+        bool active = true; // Cleared by removeWatch; guarded by dispatchMutex
+        DirectorySnapshot snapshot; // Polling only; used by the service thread
+        std::chrono::steady_clock::time_point nextScan; // Polling only
+        Coalescer coalescer; // Events held back by debouncing
+        std::chrono::steady_clock::time_point firstHeld; // When the oldest held event arrived
+        std::chrono::steady_clock::time_point lastHeld; // When the newest held event arrived
+        std::vector<FileSystemEvent> ready; // Events due for delivery
+    };
+
+    using Delivery = std::pair<std::shared_ptr<Watch>, std::vector<FileSystemEvent>>;
+
+    Logger logger; // Logger instance for logging events
+    std::mutex logMutex; // Serializes logging between callers and the service thread
+
+    mutable std::mutex stateMutex; // Guards everything below except where noted
+    std::map<WatchId, std::shared_ptr<Watch>> watches;
+    WatchId nextId = 1;
+    bool stopping = false;
+    bool nativeAvailable = false;
+    std::thread loopThread;
+    std::thread::id loopId;
+    std::unique_ptr<ThreadPool> scanPool; // Lists directories in parallel for recursive scans
+
+    std::mutex dispatchMutex; // Held while callbacks run, so removeWatch can wait for them
+
+#ifdef __linux__
+    static constexpr uint32_t watchMask = IN_CREATE | IN_MODIFY | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                          IN_DELETE_SELF | IN_MOVE_SELF;
+
+    // A directory registered with inotify and the watches whose trees contain it
+    struct WatchedDirectory {
+        std::string path;
+        std::vector<WatchId> owners;
+        std::unordered_set<std::string> names; // Entries inside, to tell when a rename replaces one
+    };
+
+    int inotifyDescriptor = -1;
+    int epollDescriptor = -1;
+    int wakeDescriptor = -1; // eventfd written to interrupt epoll_wait
+    std::unordered_map<int, WatchedDirectory> directories; // By inotify watch descriptor
+#else
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    bool wakeRequested = false;
+#endif
+
+    void log(const std::string& message) {
+        std::lock_guard<std::mutex> lock(logMutex);
+        logger.log(message);
+    }
+
+    static FileSystemEvent::Type eventType(DirectorySnapshot::Change change) {
+        switch (change) {
+        case DirectorySnapshot::Change::Created: return FileSystemEvent::Type::Created;
+        case DirectorySnapshot::Change::Modified: return FileSystemEvent::Type::Modified;
+        case DirectorySnapshot::Change::Deleted: return FileSystemEvent::Type::Deleted;
+        default: return FileSystemEvent::Type::Renamed;
+        }
+    }
+
+    static bool isWithin(const std::string& path, const std::string& directory) {
+        return path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0 && path[directory.size()] == '/';
+    }
+
+    void startLocked() {
+        if (loopThread.joinable()) {
+            return;
+        }
+#ifdef __linux__
+        epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+        wakeDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollDescriptor < 0 || wakeDescriptor < 0) {
+            throw std::runtime_error(std::string("Cannot start watch service: ") + std::strerror(errno));
+        }
+        epoll_event wakeEvent{};
+        wakeEvent.events = EPOLLIN;
+        wakeEvent.data.fd = wakeDescriptor;
+        epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, wakeDescriptor, &wakeEvent);
+        inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyDescriptor >= 0) {
+            epoll_event inotifyEvent{};
+            inotifyEvent.events = EPOLLIN;
+            inotifyEvent.data.fd = inotifyDescriptor;
+            nativeAvailable = epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, inotifyDescriptor, &inotifyEvent) == 0;
+        }
+        if (!nativeAvailable) {
+            log(std::string("inotify unavailable, falling back to polling: ") + std::strerror(errno));
+        }
+#endif
+        loopThread = std::thread([this]() { run(); });
+        loopId = loopThread.get_id();
+    }
+
+    void wake() {
+#ifdef __linux__
+        if (wakeDescriptor >= 0) {
+            uint64_t one = 1;
+            ssize_t ignored = ::write(wakeDescriptor, &one, sizeof(one));
+            (void)ignored;
+        }
+#else
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            wakeRequested = true;
+        }
+        wakeCondition.notify_one();
+#endif
+    }
+
+    void waitUntil(std::chrono::steady_clock::time_point deadline) {
+#ifdef __linux__
+        int timeout = -1;
+        if (deadline != std::chrono::steady_clock::time_point::max()) {
+            auto wait = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            timeout = static_cast<int>(std::clamp<std::chrono::milliseconds::rep>(wait.count(), 0, INT32_MAX));
+        }
+        epoll_event ready[2];
+        if (epoll_wait(epollDescriptor, ready, 2, timeout) > 0) {
+            uint64_t count;
+            ssize_t ignored = ::read(wakeDescriptor, &count, sizeof(count)); // Reset the wakeup, if any
+            (void)ignored;
+        }
+#else
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        if (deadline == std::chrono::steady_clock::time_point::max()) {
+            wakeCondition.wait(lock, [this]() { return wakeRequested; });
+        } else {
+            wakeCondition.wait_until(lock, deadline, [this]() { return wakeRequested; });
+        }
+        wakeRequested = false;
+#endif
+    }
+
+    void run() {
+        while (true) {
+            std::chrono::steady_clock::time_point deadline;
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                if (stopping) {
+                    break;
+                }
+                deadline = nextDeadlineLocked();
+            }
+            waitUntil(deadline);
+            pollDueWatches();
+            std::vector<Delivery> deliveries;
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                readNativeEventsLocked();
+                collectLocked(deliveries, false);
+            }
+            dispatch(deliveries);
+        }
+        std::vector<Delivery> deliveries;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            collectLocked(deliveries, true);
+        }
+        dispatch(deliveries);
+    }
+
+    std::chrono::steady_clock::time_point nextDeadlineLocked() const {
+        auto deadline = std::chrono::steady_clock::time_point::max();
+        for (const auto& [id, watch] : watches) {
+            if (!watch->native) {
+                deadline = std::min(deadline, watch->nextScan);
+            }
+            if (!watch->coalescer.empty()) {
+                deadline = std::min({deadline, watch->lastHeld + watch->options.debounce, watch->firstHeld + watch->options.debounce * 10});
+            }
+        }
+        return deadline;
+    }
+
+    // Scans the polling watches that are due, without holding the lock during the scans
+    void pollDueWatches() {
+        std::vector<std::shared_ptr<Watch>> due;
+        ThreadPool *pool;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            auto now = std::chrono::steady_clock::now();
+            for (const auto& [id, watch] : watches) {
+                if (!watch->native && watch->nextScan <= now) {
+                    due.push_back(watch);
+                }
+            }
+            pool = scanPool.get();
+        }
+        for (const std::shared_ptr<Watch>& watch : due) {
+            DirectorySnapshot current = DirectorySnapshot::capture(watch->root, watch->options.recursive, watch->options.recursive ? pool : nullptr);
+            std::vector<FileSystemEvent> events;
+            DirectorySnapshot::diff(watch->snapshot, current, [&events](DirectorySnapshot::Change change, const std::string& path, const std::string& oldPath, bool isDirectory) {
+                FileSystemEvent event;
+                event.type = eventType(change);
+                event.path = path;
+                event.oldPath = oldPath;
+                event.isDirectory = isDirectory;
+                events.push_back(std::move(event));
+            });
+            watch->snapshot = std::move(current);
+            std::lock_guard<std::mutex> lock(stateMutex);
+            watch->nextScan = std::chrono::steady_clock::now() + watch->options.pollInterval;
+            if (watches.count(watch->id)) {
+                emitLocked(*watch, std::move(events));
+            }
+        }
+    }
+
+    bool passesFilters(const Watch& watch, const std::string& path) const {
+        const WatchOptions& options = watch.options;
+        if (options.include.empty() && options.exclude.empty()) {
+            return true;
+        }
+        std::string_view relative = std::string_view(path).substr(std::min(path.size(), watch.root.size() + 1));
+        std::string_view name = relative.substr(relative.find_last_of('/') + 1);
+        auto matches = [&](const std::string& pattern) {
+            return matchesGlob(pattern, pattern.find('/') == std::string::npos ? name : relative);
+        };
+        if (std::any_of(options.exclude.begin(), options.exclude.end(), matches)) {
+            return false;
+        }
+        return options.include.empty() || std::any_of(options.include.begin(), options.include.end(), matches);
+    }
+
+    // Filters a watch's events and queues them for delivery, or holds them for debouncing
+    void emitLocked(Watch& watch, std::vector<FileSystemEvent> events) {
+        std::vector<FileSystemEvent> kept;
+        kept.reserve(events.size());
+        for (FileSystemEvent& event : events) {
+            bool keepNew = passesFilters(watch, event.path);
+            if (event.type == FileSystemEvent::Type::Renamed) {
+                bool keepOld = passesFilters(watch, event.oldPath);
+                if (keepOld && !keepNew) {
+                    event.type = FileSystemEvent::Type::Deleted;
+                    event.path = std::move(event.oldPath);
+                    keepNew = true;
+                } else if (keepNew && !keepOld) {
+                    event.type = FileSystemEvent::Type::Created;
+                }
+                if (event.type != FileSystemEvent::Type::Renamed) {
+                    event.oldPath.clear();
+                }
+            }
+            if (keepNew) {
+                kept.push_back(std::move(event));
+            }
+        }
+        if (kept.empty()) {
+            return;
+        }
+        if (watch.options.debounce.count() == 0) {
+            watch.ready.insert(watch.ready.end(), std::make_move_iterator(kept.begin()), std::make_move_iterator(kept.end()));
+            return;
+        }
+        watch.lastHeld = std::chrono::steady_clock::now();
+        if (watch.coalescer.empty()) {
+            watch.firstHeld = watch.lastHeld;
+        }
+        for (const FileSystemEvent& event : kept) {
+            watch.coalescer.add(event);
+        }
+    }
+
+    void collectLocked(std::vector<Delivery>& deliveries, bool flushAll) {
+        auto now = std::chrono::steady_clock::now();
+        for (auto& [id, watch] : watches) {
+            if (!watch->coalescer.empty() && (flushAll || now >= std::min(watch->lastHeld + watch->options.debounce, watch->firstHeld + watch->options.debounce * 10))) {
+                std::vector<FileSystemEvent> coalesced = watch->coalescer.take();
+                watch->ready.insert(watch->ready.end(), std::make_move_iterator(coalesced.begin()), std::make_move_iterator(coalesced.end()));
+            }
+            if (!watch->ready.empty()) {
+                deliveries.emplace_back(watch, std::move(watch->ready));
+                watch->ready.clear();
+            }
+        }
+    }
+
+    void dispatch(std::vector<Delivery>& deliveries) {
+        if (deliveries.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(dispatchMutex);
+        for (auto& [watch, events] : deliveries) {
+            if (watch->active) {
+                deliverTo(*watch, events);
+            }
+        }
+    }
+
+    void deliverTo(Watch& watch, const std::vector<FileSystemEvent>& events) {
+        try {
+            watch.deliver(events);
+        } catch (const std::exception& e) {
+            log("Watch callback for " + watch.root + " failed: " + e.what());
+        }
+    }
+
+#ifdef __linux__
+    int addDirectoryLocked(const std::string& path, WatchId owner, bool isRoot) {
+        uint32_t mask = watchMask | (isRoot ? 0 : IN_ONLYDIR | IN_DONT_FOLLOW);
+        int descriptor = inotify_add_watch(inotifyDescriptor, path.c_str(), mask);
+        if (descriptor < 0) {
+            if (errno == ENOSPC) {
+                log("inotify watch limit reached (fs.inotify.max_user_watches); not watching " + path);
+            }
+            return -1;
+        }
+        bool known = directories.count(descriptor) != 0;
+        WatchedDirectory& directory = directories[descriptor];
+        directory.path = path;
+        if (!known) {
+            // Listed after the watch exists and before its events are read, so the events keep it exact
+            if (DIR* handle = ::opendir(path.c_str())) {
+                while (dirent* item = ::readdir(handle)) {
+                    if (std::strcmp(item->d_name, ".") != 0 && std::strcmp(item->d_name, "..") != 0) {
+                        directory.names.insert(item->d_name);
+                    }
+                }
+                ::closedir(handle);
+            }
+        }
+        if (std::find(directory.owners.begin(), directory.owners.end(), owner) == directory.owners.end()) {
+            directory.owners.push_back(owner);
+        }
+        return descriptor;
+    }
+
+    // Drops the owner from the directories at or below under (all of them if under is empty) and
+    // unregisters directories nobody watches any more.
+    void releaseDirectoriesLocked(WatchId owner, const std::string& under) {
+        for (auto it = directories.begin(); it != directories.end();) {
+            std::vector<WatchId>& owners = it->second.owners;
+            if (under.empty() || it->second.path == under || isWithin(it->second.path, under)) {
+                owners.erase(std::remove(owners.begin(), owners.end(), owner), owners.end());
+            }
+            if (owners.empty()) {
+                inotify_rm_watch(inotifyDescriptor, it->first); // Fails harmlessly if already gone
+                it = directories.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    bool owns(int descriptor, WatchId owner) const {
+        auto found = directories.find(descriptor);
+        return found != directories.end() &&
+               std::find(found->second.owners.begin(), found->second.owners.end(), owner) != found->second.owners.end();
+    }
+
+    // Registers a directory that appeared in a recursive watch and reports what is already inside
+    void trackNewDirectoryLocked(Watch& watch, const std::string& path, std::vector<FileSystemEvent>& out) {
+        addDirectoryLocked(path, watch.id, false);
+        DirectorySnapshot contents = DirectorySnapshot::capture(path, true, nullptr, [this, &watch](const std::string& subdirectory) {
+            addDirectoryLocked(subdirectory, watch.id, false);
+        });
+        for (size_t i = 0; i < contents.size(); ++i) {
+            FileSystemEvent created;
+            created.type = FileSystemEvent::Type::Created;
+            created.path = contents.fullPath(i);
+            created.isDirectory = contents.entry(i).isDirectory;
+            out.push_back(std::move(created));
+        }
+    }
+
+    // Drains the inotify descriptor and hands each watch the events of its directories. A rename
+    // arrives as IN_MOVED_FROM and IN_MOVED_TO sharing a cookie; the pair becomes one Renamed event
+    // for watches that see both directories, and a Deleted or Created event for watches that see
+    // only one of them.
+    void readNativeEventsLocked() {
+        if (inotifyDescriptor < 0) {
+            return;
+        }
+        struct Change {
+            FileSystemEvent event;
+            int descriptor;            // Directory of event.path
+            int sourceDescriptor = -1; // For renames, the directory of event.oldPath
+            bool self = false;         // The watched directory itself was deleted or moved
+            bool replaced = false;     // Moved onto an existing entry, which is gone now
+        };
+        alignas(inotify_event) char buffer[64 * 1024];
+        std::vector<Change> changes;
+        std::unordered_map<uint32_t, size_t> movedFrom; // Cookie to index in changes
+        std::vector<int> ignored; // Directories that are gone, dropped once their last events are routed
+        while (true) {
+            ssize_t length = ::read(inotifyDescriptor, buffer, sizeof(buffer));
+            if (length < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno != EAGAIN) {
+                    log(std::string("Reading inotify events failed: ") + std::strerror(errno));
+                }
+                break;
+            }
+            for (char* cursor = buffer; cursor < buffer + length;) {
+                const inotify_event* raw = reinterpret_cast<const inotify_event*>(cursor);
+                cursor += sizeof(inotify_event) + raw->len;
+                if (raw->mask & IN_Q_OVERFLOW) {
+                    log("inotify queue overflowed; some changes were not reported");
+                    continue;
+                }
+                auto directory = directories.find(raw->wd);
+                if (directory == directories.end()) {
+                    continue;
+                }
+                if (raw->mask & IN_IGNORED) {
+                    ignored.push_back(raw->wd);
+                    continue;
+                }
+                Change change;
+                change.descriptor = raw->wd;
+                change.self = (raw->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) != 0;
+                FileSystemEvent& event = change.event;
+                event.isDirectory = (raw->mask & IN_ISDIR) != 0 || change.self;
+                event.path = raw->len > 0 ? directory->second.path + '/' + raw->name : directory->second.path;
+                std::unordered_set<std::string>& names = directory->second.names;
+                if (raw->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    change.replaced = !names.insert(raw->name).second && (raw->mask & IN_MOVED_TO);
+                } else if (raw->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    names.erase(raw->name);
+                }
+                if (raw->mask & IN_CREATE) {
+                    event.type = FileSystemEvent::Type::Created;
+                } else if (raw->mask & IN_MODIFY) {
+                    event.type = FileSystemEvent::Type::Modified;
+                } else if (raw->mask & (IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF)) {
+                    event.type = FileSystemEvent::Type::Deleted;
+                } else if (raw->mask & IN_MOVED_FROM) {
+                    event.type = FileSystemEvent::Type::Deleted; // Until the matching IN_MOVED_TO arrives
+                    movedFrom[raw->cookie] = changes.size();
+                } else if (raw->mask & IN_MOVED_TO) {
+                    auto source = movedFrom.find(raw->cookie);
+                    if (source != movedFrom.end()) {
+                        Change& rename = changes[source->second];
+                        rename.event.type = FileSystemEvent::Type::Renamed;
+                        rename.event.oldPath = std::move(rename.event.path);
+                        rename.event.path = std::move(event.path);
+                        rename.sourceDescriptor = rename.descriptor;
+                        rename.descriptor = raw->wd;
+                        rename.replaced = change.replaced;
+                        movedFrom.erase(source);
+                        continue;
+                    }
+                    event.type = FileSystemEvent::Type::Created;
+                } else {
+                    continue;
+                }
+                changes.push_back(std::move(change));
+            }
+        }
+        std::unordered_map<WatchId, std::vector<FileSystemEvent>> perWatch;
+        for (Change& change : changes) {
+            const FileSystemEvent& event = change.event;
+            if (event.type == FileSystemEvent::Type::Renamed && event.isDirectory) {
+                // Keep the registered paths of the moved subtree current
+                for (auto& [descriptor, directory] : directories) {
+                    if (directory.path == event.oldPath || isWithin(directory.path, event.oldPath)) {
+                        directory.path = event.path + directory.path.substr(event.oldPath.size());
+                    }
+                }
+            }
+            std::vector<WatchId> owners;
+            for (int descriptor : {change.descriptor, change.sourceDescriptor}) {
+                auto directory = directories.find(descriptor);
+                if (directory != directories.end()) {
+                    for (WatchId owner : directory->second.owners) {
+                        if (std::find(owners.begin(), owners.end(), owner) == owners.end()) {
+                            owners.push_back(owner);
+                        }
+                    }
+                }
+            }
+            for (WatchId owner : owners) {
+                auto found = watches.find(owner);
+                if (found == watches.end()) {
+                    continue;
+                }
+                Watch& watch = *found->second;
+                if (change.self) {
+                    if (watch.root == event.path) {
+                        perWatch[owner].push_back(event); // Subdirectories are reported by their parent
+                    }
+                    continue;
+                }
+                FileSystemEvent view = event;
+                if (view.type == FileSystemEvent::Type::Renamed) {
+                    if (!owns(change.descriptor, owner)) {
+                        view.type = FileSystemEvent::Type::Deleted; // Moved out of this watch's tree
+                        view.path = std::move(view.oldPath);
+                        view.oldPath.clear();
+                    } else if (!owns(change.sourceDescriptor, owner)) {
+                        view.type = FileSystemEvent::Type::Created; // Moved in
+                        view.oldPath.clear();
+                    }
+                }
+                std::vector<FileSystemEvent>& out = perWatch[owner];
+                if (change.replaced && owns(change.descriptor, owner)) {
+                    FileSystemEvent deleted;
+                    deleted.type = FileSystemEvent::Type::Deleted;
+                    deleted.path = event.path;
+                    deleted.isDirectory = event.isDirectory;
+                    out.push_back(std::move(deleted));
+                }
+                out.push_back(view);
+                if (watch.options.recursive && view.isDirectory) {
+                    if (view.type == FileSystemEvent::Type::Created) {
+                        trackNewDirectoryLocked(watch, view.path, out);
+                    } else if (view.type == FileSystemEvent::Type::Deleted) {
+                        // After a rename the subtree's registered paths already carry the new name
+                        releaseDirectoriesLocked(owner, event.type == FileSystemEvent::Type::Renamed ? event.path : view.path);
+                    }
+                }
+            }
+        }
+        for (int descriptor : ignored) {
+            directories.erase(descriptor);
+        }
+        for (auto& [owner, events] : perWatch) {
+            emitLocked(*watches[owner], std::move(events));
+        }
+    }
+#else
+    int addDirectoryLocked(const std::string&, WatchId, bool) {
+        return -1;
+    }
+
+    void releaseDirectoriesLocked(WatchId, const std::string&) {}
+
+    void readNativeEventsLocked() {}
+#endif
+};
+
+#endif // WATCHSERVICE_HPP
@@ -0,0 +1,566 @@
+#ifndef XMLPARSER_HPP
+#define XMLPARSER_HPP
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Document.hpp"
+
+/**
+ * @brief The XmlPullParser class is a single-pass, non-recursive XML tokenizer.
+ *
+ * The caller pulls one event at a time with next(). Names, attribute values and text are
+ * string_views into the input, so nothing is copied until a value is decoded. Element nesting is
+ * tracked on an explicit stack, so deep documents cannot exhaust the call stack.
+ *
+ * Supported: elements, attributes (single or double quoted), self-closing tags, character data,
+ * CDATA sections, comments, processing instructions, the XML declaration and DOCTYPE (skipped),
+ * the five predefined entities and numeric character references.
+ */
+class XmlPullParser
+{
+public:
+    /**
+     * @brief The kind of token returned by next().
+     */
+    enum class Event
+    {
+        StartElement,          // name() and attributes() are set
+        EndElement,            // name() is set; also reported for self-closing tags
+        Text,                  // rawText() holds undecoded character data
+        CData,                 // rawText() holds the literal section content
+        Comment,               // rawText() holds the comment body
+        ProcessingInstruction, // name() is the target, rawText() the instruction body
+        EndDocument            // No more input
+    };
+
+    /**
+     * @brief An attribute of the current start element.
+     */
+    struct Attribute
+    {
+        std::string_view name;
+        std::string_view rawValue; // Value without quotes, entities not yet decoded
+
+        std::string value() const { return decodeEntities(rawValue); }
+    };
+
+    /**
+     * @brief Creates a parser over the given text.
+     * @param xml The XML text; it must outlive the parser and every view it returns.
+     * @param skipWhitespace Whether whitespace-only text between tags is dropped.
+     */
+    explicit XmlPullParser(std::string_view xml, bool skipWhitespace = true)
+        : xml(xml), skipWhitespace(skipWhitespace) {}
+
+    /**
+     * @brief Advances to the next event.
+     * @return The event type.
+     * @throws std::runtime_error if the markup is malformed, elements are left open, or content
+     * other than comments and processing instructions appears outside of a single root element.
+     */
+    Event next()
+    {
+        currentAttributes.clear();
+        currentName = {};
+        currentText = {};
+        if (pendingEnd)
+        {
+            pendingEnd = false;
+            currentName = openElements.back();
+            openElements.pop_back();
+            return Event::EndElement;
+        }
+        while (position < xml.size())
+        {
+            if (xml[position] != '<')
+            {
+                size_t open = xml.find('<', position);
+                size_t end = open == std::string_view::npos ? xml.size() : open;
+                std::string_view text = xml.substr(position, end - position);
+                position = end;
+                if ((skipWhitespace || openElements.empty()) && isWhitespace(text))
+                {
+                    continue; // Whitespace outside of the root is never reported
+                }
+                if (openElements.empty())
+                {
+                    fail("text outside of the root element");
+                }
+                currentText = text;
+                return Event::Text;
+            }
+            if (startsWith("<!--"))
+            {
+                currentText = readUntil(position + 4, "-->", "unterminated comment");
+                return Event::Comment;
+            }
+            if (startsWith("<![CDATA["))
+            {
+                if (openElements.empty())
+                {
+                    fail("CDATA section outside of the root element");
+                }
+                currentText = readUntil(position + 9, "]]>", "unterminated CDATA section");
+                return Event::CData;
+            }
+            if (startsWith("<?"))
+            {
+                std::string_view body = readUntil(position + 2, "?>", "unterminated processing instruction");
+                size_t nameEnd = 0;
+                while (nameEnd < body.size() && !isSpace(body[nameEnd]))
+                    ++nameEnd;
+                currentName = body.substr(0, nameEnd);
+                currentText = trim(body.substr(nameEnd));
+                if (currentName == "xml")
+                {
+                    currentName = {};
+                    currentText = {};
+                    continue; // The XML declaration carries no content
+                }
+                return Event::ProcessingInstruction;
+            }
+            if (startsWith("<!"))
+            {
+                skipDeclaration();
+                continue;
+            }
+            if (startsWith("</"))
+            {
+                return readEndTag();
+            }
+            return readStartTag();
+        }
+        if (!openElements.empty())
+        {
+            fail("unclosed element <" + std::string(openElements.back()) + ">");
+        }
+        return Event::EndDocument;
+    }
+
+    std::string_view name() const { return currentName; }
+    std::string_view rawText() const { return currentText; }
+
+    /**
+     * @brief Returns the text of the current Text (entities decoded) or CData event.
+     */
+    std::string text(Event event) const
+    {
+        return event == Event::Text ? decodeEntities(currentText) : std::string(currentText);
+    }
+
+    const std::vector<Attribute> &attributes() const { return currentAttributes; }
+
+    /**
+     * @brief Returns the number of currently open elements.
+     */
+    size_t depth() const { return openElements.size(); }
+
+    /**
+     * @brief Returns the byte offset of the next unread character.
+     */
+    size_t offset() const { return position; }
+
+    /**
+     * @brief Replaces the predefined and numeric character references in XML text.
+     * Unknown or malformed references are kept verbatim.
+     * @param raw The raw character data.
+     * @return The decoded text.
+     */
+    static std::string decodeEntities(std::string_view raw)
+    {
+        std::string decoded;
+        decoded.reserve(raw.size());
+        size_t i = 0;
+        while (i < raw.size())
+        {
+            size_t amp = raw.find('&', i);
+            if (amp == std::string_view::npos)
+            {
+                decoded.append(raw.data() + i, raw.size() - i);
+                break;
+            }
+            decoded.append(raw.data() + i, amp - i);
+            size_t semicolon = raw.find(';', amp);
+            if (semicolon == std::string_view::npos)
+            {
+                decoded.append(raw.data() + amp, raw.size() - amp);
+                break;
+            }
+            std::string_view entity = raw.substr(amp + 1, semicolon - amp - 1);
+            if (entity == "lt")
+                decoded.push_back('<');
+            else if (entity == "gt")
+                decoded.push_back('>');
+            else if (entity == "amp")
+                decoded.push_back('&');
+            else if (entity == "quot")
+                decoded.push_back('"');
+            else if (entity == "apos")
+                decoded.push_back('\'');
+            else if (entity.size() > 1 && entity[0] == '#')
+            {
+                bool hex = entity[1] == 'x' || entity[1] == 'X';
+                std::string_view digits = entity.substr(hex ? 2 : 1);
+                uint32_t codePoint = 0;
+                auto result = std::from_chars(digits.data(), digits.data() + digits.size(), codePoint, hex ? 16 : 10);
+                if (digits.empty() || result.ptr != digits.data() + digits.size())
+                {
+                    decoded.append(raw.data() + amp, semicolon - amp + 1);
+                }
+                else
+                {
+                    appendUtf8(decoded, codePoint);
+                }
+            }
+            else
+            {
+                decoded.append(raw.data() + amp, semicolon - amp + 1);
+            }
+            i = semicolon + 1;
+        }
+        return decoded;
+    }
+
+    /**
+     * @brief Parses an XML text into a Document whose strings are copied into the document's arena.
+     *
+     * The root is an object holding the root element as its only member. An element without
+     * attributes or child elements becomes a string member named after its tag. Any other element
+     * becomes an object whose members are its attributes ("@name"), its child elements in document
+     * order (repeated tags give repeated keys) and, if it has character data, a "#text" member
+     * placed after the children.
+     * @param xml The XML text.
+     * @return The parsed document.
+     * @throws std::runtime_error if the markup is malformed.
+     */
+    static Document parseDocument(std::string_view xml)
+    {
+        return buildDocument(xml, false);
+    }
+
+    /**
+     * @brief Same as parseDocument, but names and text without entities point into the input.
+     * The input must outlive the document; Document::retainSource() can tie the two together.
+     */
+    static Document parseDocumentInPlace(std::string_view xml)
+    {
+        return buildDocument(xml, true);
+    }
+
+private:
+    /**
+     * @brief An element that is open while a Document is being built.
+     */
+    struct ElementFrame
+    {
+        std::string_view name;
+        bool opened = false;    // Already emitted as an object because it has attributes or children
+        bool joined = false;    // Character data arrived in more than one segment
+        std::string_view text;  // The only segment of character data so far
+        std::string joinedText; // All segments, once joined is set
+    };
+
+    std::string_view xml;
+    bool skipWhitespace;
+    size_t position = 0;
+    bool pendingEnd = false;                    // A self-closing tag still owes its EndElement
+    bool rootSeen = false;                      // The root element has been opened
+    std::vector<std::string_view> openElements; // Names of open elements, outermost first
+    std::string_view currentName;
+    std::string_view currentText;
+    std::vector<Attribute> currentAttributes;
+
+    static Document buildDocument(std::string_view xml, bool inPlace)
+    {
+        XmlPullParser parser(xml);
+        Document document;
+        document.reserve(xml.size() / 32 + 16);
+        document.openContainer(Document::Type::Object);
+        std::vector<ElementFrame> frames;
+
+        auto keep = [&](std::string_view text)
+        { return inPlace ? text : document.store(text); };
+        auto decode = [&](std::string_view raw)
+        { return raw.find('&') == std::string_view::npos ? keep(raw) : document.store(decodeEntities(raw)); };
+        auto open = [&](ElementFrame &frame)
+        {
+            if (!frame.opened)
+            {
+                document.openContainer(Document::Type::Object, keep(frame.name));
+                frame.opened = true;
+            }
+        };
+
+        for (Event event = parser.next(); event != Event::EndDocument; event = parser.next())
+        {
+            switch (event)
+            {
+            case Event::StartElement:
+                if (!frames.empty())
+                {
+                    open(frames.back());
+                }
+                frames.emplace_back();
+                frames.back().name = parser.name();
+                if (!parser.attributes().empty())
+                {
+                    open(frames.back());
+                    for (const Attribute &attribute : parser.attributes())
+                    {
+                        char *key = document.allocateText(attribute.name.size() + 1);
+                        key[0] = '@';
+                        std::memcpy(key + 1, attribute.name.data(), attribute.name.size());
+                        document.addScalar(Document::Type::String, std::string_view(key, attribute.name.size() + 1), decode(attribute.rawValue));
+                    }
+                }
+                break;
+            case Event::Text:
+            case Event::CData:
+            {
+                ElementFrame &frame = frames.back();
+                std::string_view segment = event == Event::Text ? decode(parser.rawText()) : keep(parser.rawText());
+                if (!frame.joined && frame.text.empty())
+                {
+                    frame.text = segment;
+                }
+                else
+                {
+                    if (!frame.joined)
+                    {
+                        frame.joinedText.assign(frame.text);
+                        frame.joined = true;
+                    }
+                    frame.joinedText.append(segment);
+                }
+                break;
+            }
+            case Event::EndElement:
+            {
+                ElementFrame &frame = frames.back();
+                std::string_view text = frame.joined ? document.store(frame.joinedText) : frame.text;
+                if (!frame.opened)
+                {
+                    document.addScalar(Document::Type::String, keep(frame.name), text);
+                }
+                else
+                {
+                    if (!text.empty())
+                    {
+                        document.addScalar(Document::Type::String, "#text", text);
+                    }
+                    document.closeContainer();
+                }
+                frames.pop_back();
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        document.closeContainer();
+        return document;
+    }
+
+    static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    static bool isWhitespace(std::string_view text)
+    {
+        for (char c : text)
+        {
+            if (!isSpace(c))
+                return false;
+        }
+        return true;
+    }
+
+    static std::string_view trim(std::string_view text)
+    {
+        while (!text.empty() && isSpace(text.front()))
+            text.remove_prefix(1);
+        while (!text.empty() && isSpace(text.back()))
+            text.remove_suffix(1);
+        return text;
+    }
+
+    static void appendUtf8(std::string &out, uint32_t codePoint)
+    {
+        if (codePoint < 0x80)
+        {
+            out.push_back(static_cast<char>(codePoint));
+        }
+        else if (codePoint < 0x800)
+        {
+            out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else if (codePoint < 0x10000)
+        {
+            out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+
+    [[noreturn]] void fail(const std::string &message) const
+    {
+        throw std::runtime_error("Invalid XML at offset " + std::to_string(position) + ": " + message);
+    }
+
+    bool startsWith(std::string_view prefix) const
+    {
+        return xml.compare(position, prefix.size(), prefix) == 0;
+    }
+
+    // Returns the text between start and the terminator and moves past the terminator.
+    std::string_view readUntil(size_t start, std::string_view terminator, const char *error)
+    {
+        size_t end = xml.find(terminator, start);
+        if (end == std::string_view::npos)
+        {
+            fail(error);
+        }
+        position = end + terminator.size();
+        return xml.substr(start, end - start);
+    }
+
+    // Skips <!DOCTYPE ...> and similar declarations, including a bracketed internal subset.
+    void skipDeclaration()
+    {
+        size_t depthInSubset = 0;
+        char quote = 0;
+        for (size_t i = position + 2; i < xml.size(); ++i)
+        {
+            char c = xml[i];
+            if (quote)
+            {
+                if (c == quote)
+                    quote = 0;
+            }
+            else if (c == '"' || c == '\'')
+                quote = c;
+            else if (c == '[')
+                ++depthInSubset;
+            else if (c == ']' && depthInSubset > 0)
+                --depthInSubset;
+            else if (c == '>' && depthInSubset == 0)
+            {
+                position = i + 1;
+                return;
+            }
+        }
+        fail("unterminated declaration");
+    }
+
+    std::string_view readName()
+    {
+        size_t start = position;
+        while (position < xml.size() && !isSpace(xml[position]) && xml[position] != '>' && xml[position] != '/' && xml[position] != '=')
+        {
+            ++position;
+        }
+        if (position == start)
+        {
+            fail("expected a name");
+        }
+        return xml.substr(start, position - start);
+    }
+
+    void skipSpaces()
+    {
+        while (position < xml.size() && isSpace(xml[position]))
+            ++position;
+    }
+
+    Event readEndTag()
+    {
+        position += 2;
+        currentName = readName();
+        skipSpaces();
+        if (position >= xml.size() || xml[position] != '>')
+        {
+            fail("expected '>' after closing tag name");
+        }
+        ++position;
+        if (openElements.empty() || openElements.back() != currentName)
+        {
+            fail("mismatched closing tag </" + std::string(currentName) + ">");
+        }
+        openElements.pop_back();
+        return Event::EndElement;
+    }
+
+    Event readStartTag()
+    {
+        if (openElements.empty())
+        {
+            if (rootSeen)
+            {
+                fail("more than one root element");
+            }
+            rootSeen = true;
+        }
+        ++position;
+        currentName = readName();
+        while (true)
+        {
+            skipSpaces();
+            if (position >= xml.size())
+            {
+                fail("unterminated tag <" + std::string(currentName) + ">");
+            }
+            if (xml[position] == '>')
+            {
+                ++position;
+                openElements.push_back(currentName);
+                return Event::StartElement;
+            }
+            if (xml[position] == '/')
+            {
+                if (position + 1 >= xml.size() || xml[position + 1] != '>')
+                {
+                    fail("expected '/>'");
+                }
+                position += 2;
+                openElements.push_back(currentName);
+                pendingEnd = true;
+                return Event::StartElement;
+            }
+            Attribute attribute;
+            attribute.name = readName();
+            skipSpaces();
+            if (position >= xml.size() || xml[position] != '=')
+            {
+                fail("expected '=' after attribute " + std::string(attribute.name));
+            }
+            ++position;
+            skipSpaces();
+            if (position >= xml.size() || (xml[position] != '"' && xml[position] != '\''))
+            {
+                fail("expected quoted value for attribute " + std::string(attribute.name));
+            }
+            char quote = xml[position++];
+            size_t end = xml.find(quote, position);
+            if (end == std::string_view::npos)
+            {
+                fail("unterminated value for attribute " + std::string(attribute.name));
+            }
+            attribute.rawValue = xml.substr(position, end - position);
+            position = end + 1;
+            currentAttributes.push_back(attribute);
+        }
+    }
+};
+
+#endif // XMLPARSER_HPP
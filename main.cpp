@@ -335,6 +335,14 @@ void FileParserExamples()
         for (const auto &[key, value] : xmlData)
             std::cout << (key + ": " + value) << std::endl;
 
+        std::cout << "All files in data (format detected from content):" << std::endl;
+        parser.parseDirectory("data", [](const FileParser::ParsedFile &file)
+                              {
+            if (file.error.empty())
+                std::cout << (file.path + ": " + std::to_string(file.data.size()) + " values") << std::endl;
+            else
+                std::cout << (file.path + ": " + file.error) << std::endl; });
+
         parser.writeToFile("data/output.txt");
     }
     catch (const std::exception &e)